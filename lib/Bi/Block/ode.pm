@@ -59,12 +59,24 @@ An order 5(4) Dormand-Prince with adaptive step size.
 
 An order 4(3) low-storage Runge-Kutta with adaptive step size.
 
+=item C<'ROS3(2)'>
+
+An order 3(2) L-stable Rosenbrock (linearly implicit) method with adaptive
+step size, for stiff systems. The Jacobian of the system is derived
+symbolically from the differential equations, so these may not use the
+ternary operator C<?:>. Each variable must be updated by a single equation
+over its full range. Over each step, the system is treated as autonomous,
+the Jacobian is evaluated only at the start of the step, and is reused if
+the step is rejected. This method is not supported on GPU.
+
 =back
 
 =item C<h> (position 1, default 1.0)
 
 For a fixed step size, the step size to use. For an adaptive step size, the
-suggested initial step size to use.
+suggested initial step size to use. This is used only for the first
+integration of each trajectory; subsequent integrations start from the step
+size that was last proposed for that trajectory.
 
 =item C<atoler> (position 2, default 1.0e-3)
 
@@ -106,14 +118,24 @@ sub validate {
     $self->process_args($BLOCK_ARGS);
     
     my $alg = $self->get_named_arg('alg')->eval_const;
-    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)') {
+    if ($alg ne 'RK4' && $alg ne 'RK5(4)' && $alg ne 'RK4(3)' &&
+            $alg ne 'ROS3(2)') {
         die("unrecognised value '$alg' for argument 'alg' of block 'ode'\n");
     }
     
+    my %targets;
     foreach my $action (@{$self->get_actions}) {
         if ($action->get_name ne 'ode_') {
             die("an 'ode' block may only contain ordinary differential equation actions\n");
         }
+        if ($alg eq 'ROS3(2)') {
+            my $var = $action->get_left->get_var;
+            my $name = $var->get_name;
+            if (exists $targets{$name} || $action->get_size != $var->get_size) {
+                die("with 'ROS3(2)', each variable in an 'ode' block must be updated by a single equation over its full range, but '$name' is not\n");
+            }
+            $targets{$name} = 1;
+        }
     }
 }
 
@@ -81,6 +81,18 @@ Enable SSE code.
 
 Enable AVX code.
 
+=item C<--enable-sse-lanes> (default off)
+
+Under C<--enable-sse> or C<--enable-avx>, give each SIMD lane its own step
+size in adaptive ODE integrators, rather than sharing one step size across
+all lanes. This helps when step sizes vary greatly between trajectories.
+
+=item C<--enable-padded-state> (default off)
+
+Pad the storage of each state variable to an odd number of cache lines, so
+that the variables of a trajectory do not all map to the same cache sets.
+This helps when the number of particles is a large power of two.
+
 =item C<--enable-mpi> (default off)
 
 Enable MPI code.
@@ -144,6 +156,8 @@ sub new {
         _gpu_cache => 0,
         _sse => 0,
         _avx => 0,
+        _sse_lanes => 0,
+        _padded_state => 0,
         _mpi => 0,
         _vampir => 0,
         _single => 0,
@@ -172,6 +186,10 @@ sub new {
         'disable-sse' => sub { $self->{_sse} = 0 },
         'enable-avx' => sub { $self->{_avx} = 1 },
         'disable-avx' => sub { $self->{_avx} = 0 },
+        'enable-sse-lanes' => sub { $self->{_sse_lanes} = 1 },
+        'disable-sse-lanes' => sub { $self->{_sse_lanes} = 0 },
+        'enable-padded-state' => sub { $self->{_padded_state} = 1 },
+        'disable-padded-state' => sub { $self->{_padded_state} = 0 },
         'enable-mpi' => sub { $self->{_mpi} = 1 },
         'disable-mpi' => sub { $self->{_mpi} = 0 },
         'enable-vampir' => sub { $self->{_vampir} = 1 },
@@ -217,6 +235,8 @@ sub new {
     push(@builddir, 'gpucache') if $self->{_gpu_cache};
     push(@builddir, 'sse') if $self->{_sse};
     push(@builddir, 'avx') if $self->{_avx};
+    push(@builddir, 'sselanes') if $self->{_sse_lanes};
+    push(@builddir, 'paddedstate') if $self->{_padded_state};
     push(@builddir, 'mpi') if $self->{_mpi};
     push(@builddir, 'vampir') if $self->{_vampir};
     push(@builddir, 'single') if $self->{_single};
@@ -337,6 +357,8 @@ sub _configure {
     $options .= $self->{_gpu_cache} ? ' --enable-gpucache' : ' --disable-gpucache';
     $options .= $self->{_sse} ? ' --enable-sse' : ' --disable-sse';
     $options .= $self->{_avx} ? ' --enable-avx' : ' --disable-avx';
+    $options .= $self->{_sse_lanes} ? ' --enable-sselanes' : ' --disable-sselanes';
+    $options .= $self->{_padded_state} ? ' --enable-paddedstate' : ' --disable-paddedstate';
     $options .= $self->{_mpi} ? ' --enable-mpi' : ' --disable-mpi';
     $options .= $self->{_vampir} ? ' --enable-vampir' : ' --disable-vampir';
     $options .= $self->{_single} ? ' --enable-single' : ' --disable-single';
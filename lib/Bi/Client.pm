@@ -29,6 +29,57 @@ Pseudorandom number generator seed.
 Run with C<N> threads. If zero, the number of threads used is the
 default for OpenMP on the platform.
 
+=item C<--ode-chunk I<N>> (default 0)
+
+Schedule trajectories across threads dynamically, in chunks of C<N>
+trajectories, when integrating C<ode> blocks with an adaptive step size. If
+zero, trajectories are divided evenly between threads. Dynamic scheduling
+helps when the number of steps taken varies greatly between trajectories.
+Results do not depend on this setting.
+
+=item C<--transition-tile I<N>> (default 0)
+
+Run all blocks of the transition model over one tile of trajectories before
+moving on to the next tile, with C<N> trajectories per thread in each tile.
+Each thread then keeps its share of a tile in cache from one block to the
+next, rather than each block passing over all trajectories in turn. Choose
+C<N> so that the state of C<N> trajectories fits in the L2 cache of one core.
+If zero, the transition model is not tiled. Results do not depend on the tile
+size, nor on whether tiling is used. Host only.
+
+=item C<--with-ode-dense-output> (default off)
+
+Use dense output for C<ode> blocks with the C<'RK5(4)'> integrator. Steps
+are then not truncated at output and observation times. Instead, the state at
+those times is interpolated, and integration continues from the end of the
+last step, as long as nothing else has changed the state in the meantime.
+This can greatly reduce the number of steps taken when outputs are dense.
+Dense output is supported on host only; with C<--enable-sse> it selects the
+non-SSE integrator.
+
+=item C<--with-persistent-team> (default off)
+
+Run each step of the bootstrap particle filter, from one observation to the
+next, within a single team of threads, rather than forking a new team for
+each block of the transition model. Resampling, weighting and output run on
+one thread of the team while the others wait. This reduces latency per step
+when the number of particles is small. Host only.
+
+=item C<--with-first-touch> (default off)
+
+Allocate the state of each particle on the NUMA node of the thread that
+updates it. Each thread first touches the storage of its own share of
+particles, rather than the main thread touching all of it. This helps on
+machines with more than one socket. Bind threads to cores, e.g. with the
+C<OMP_PROC_BIND=true> environment variable, so that they keep their share of
+particles on the same node. Host only.
+
+=item C<--with-huge-pages> (default off)
+
+Ask the operating system to back large host allocations with huge pages.
+This reduces TLB misses when the state is large. With
+C<--with-first-touch>, placement is then by huge page rather than by page.
+
 =item C<--with-gdb> (default off)
 
 Run within the C<gdb> debugger.
@@ -247,6 +298,36 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 0
     },
+    {
+      name => 'ode-chunk',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'transition-tile',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'with-ode-dense-output',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'with-persistent-team',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'with-first-touch',
+      type => 'bool',
+      default => 0
+    },
+    {
+      name => 'with-huge-pages',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'gperftools-file',
       type => 'string',
@@ -133,7 +133,16 @@ for a Metropolis resampler (Murray 2011),
 
 =item C<rejection>
 
-for a rejection resampler (Murray, Lee & Jacob 2013), or
+for a rejection resampler (Murray, Lee & Jacob 2013),
+
+=item C<residual>
+
+for a residual resampler (Liu & Chen 1998), with the residual offspring
+drawn multinomially, or
+
+=item C<residual-systematic>
+
+for a residual resampler with the residual offspring drawn systematically.
 
 =back
 
@@ -152,6 +161,15 @@ Sort weights prior to resampling.
 Resample from a kernel density estimate of the filter density (in the style
 of Liu & West 2001).
 
+=item C<--with-hilbert-sort> (default off)
+
+Order particles along a Hilbert curve through their states prior to
+resampling (Skilling 2004), so that the ancestors chosen change smoothly with
+the weights and random variates. Only state variables are used, not noise
+variables, with fewer bits of each the more state variables there are (at
+most 64 bits in total). This is recommended with C<sample --correlation>. It is not available with C<--resampler rejection>,
+C<--with-kde> or C<--filter adaptive>, and overrides C<--with-sort>.
+
 =back
 
 =head2 Kernel density estimate options
@@ -316,6 +334,11 @@ our @CLIENT_OPTIONS = (
       type => 'bool',
       default => 0
     },
+    {
+      name => 'with-hilbert-sort',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'b-abs',
       type => 'float',
@@ -402,6 +425,19 @@ sub process_args {
     if ($filter eq 'kalman') {
         $self->set_named_arg('with-transform-extended', 1);
     }
+    if ($self->get_named_arg('with-hilbert-sort')) {
+        if ($self->get_named_arg('resampler') eq 'rejection' ||
+                $self->get_named_arg('with-kde')) {
+            warn("--with-hilbert-sort is not available with this resampler, disabling.\n");
+            $self->set_named_arg('with-hilbert-sort', 0);
+        } elsif ($filter eq 'adaptive') {
+            warn("--with-hilbert-sort is not available with --filter adaptive, disabling.\n");
+            $self->set_named_arg('with-hilbert-sort', 0);
+        } elsif ($self->get_named_arg('with-sort')) {
+            warn("--with-hilbert-sort overrides --with-sort, disabling --with-sort.\n");
+            $self->set_named_arg('with-sort', 0);
+        }
+    }
     $self->{_binary} = 'filter';
 }
 
@@ -69,6 +69,13 @@ The type of sampler to use for C<--target posterior>; one of:
 
 Marginal Metropolis-Hastings (MH).
 
+=item C<da>
+
+Marginal delayed-acceptance Metropolis-Hastings (DA). As MH, but each proposal
+is first screened with the marginal likelihood estimate of an extended Kalman
+filter, and only those that pass are passed to the filter given by
+C<--filter>. The second acceptance ratio corrects for the screen.
+
 =item C<sir> or (deprecated) C<smc2>
 
 Marginal sequential importance resampling (SIR).
@@ -83,7 +90,7 @@ Marginal sequential rejection sampling (SRS).
 
 =back
 
-For MH, the proposal works according to the L<proposal_parameter> top-level
+For MH and DA, the proposal works according to the L<proposal_parameter> top-level
 block in the model. If this is not defined, independent draws are taken from
 the L<parameter> top-level block instead. If
 C<--with-transform-initial-to-param> is used, the L<proposal_initial>
@@ -100,6 +107,36 @@ Number of samples to draw.
 
 =back
 
+=head2 MH-specific options
+
+=over 4
+
+=item C<--nchains> (default 1)
+
+Number of chains to run concurrently, each on one thread with its own filter
+state. The chains share inputs, observations and the time schedule, which are
+read only once. Each chain draws C<--nsamples> samples, with those of chain
+C<k> (counting from zero) written to indices C<k*nsamples> to
+C<(k+1)*nsamples-1> of the output file. As the filter of each chain then
+runs single-threaded, this is best used with at least as many chains as
+threads. It is not available with C<--filter adaptive>,
+C<--resampler rejection> or C<--transition-tile>.
+
+=item C<--correlation> (default 0)
+
+Correlation of the random variates of the filter between the current and
+proposed parameters, for the correlated pseudo-marginal method (Deligiannidis,
+Doucet & Pitt 2018). Zero draws them afresh for each proposal, as usual. A
+value close to one, such as 0.99, correlates the log-likelihood estimates, so
+that fewer particles are needed for the same acceptance rate. Best combined
+with C<--with-hilbert-sort>. Only the random variates drawn on the host are
+correlated. Not available with C<--nchains> greater than one, nor with
+C<--resampler metropolis>, which draws its variates one at a time within a
+parallel loop, so that their order in the replayed stream would depend on
+the schedule of threads.
+
+=back
+
 =head2 SIR-specific options
 
 =over 4
@@ -108,6 +145,15 @@ Number of samples to draw.
 
 Number of MH steps to perform after each resample.
 
+=item C<--with-parallel-theta> (default off)
+
+Extend and rejuvenate parameter particles concurrently, each on one thread
+with its own filter state, rather than one after the other with each filter
+using all threads. This is usually faster when there are many more parameter
+particles than threads. It is not available with C<--filter adaptive>,
+C<--resampler rejection> or C<--transition-tile>, and is ignored when
+running on GPU.
+
 =item C<--sample-resampler> (default C<systematic>)
 
 The type of resampler to use on parameter particles, see C<--resampler> for
@@ -172,6 +218,16 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => 1
     },
+    {
+      name => 'nchains',
+      type => 'int',
+      default => 1
+    },
+    {
+      name => 'correlation',
+      type => 'float',
+      default => 0.0
+    },
     {
       name => 'conditional-pf',
       type => 'int',
@@ -187,6 +243,11 @@ our @CLIENT_OPTIONS = (
       type => 'int',
       default => '1'
     },
+    {
+      name => 'with-parallel-theta',
+      type => 'bool',
+      default => 0
+    },
     {
       name => 'sample-resampler',
       type => 'string',
@@ -245,6 +306,44 @@ sub process_args {
     	if ($sampler eq 'sir' || $sampler eq 'smc2') {
 	    	$self->set_named_arg('sampler', 'sir'); # standardise name
     	}
+    	if ($self->get_named_arg('with-parallel-theta') &&
+    	        ($filter eq 'adaptive' ||
+    	        $self->get_named_arg('resampler') eq 'rejection')) {
+    	    warn("--with-parallel-theta is not available with this filter or resampler, disabling.\n");
+    	    $self->set_named_arg('with-parallel-theta', 0);
+    	}
+    	if ($self->get_named_arg('nchains') > 1) {
+    	    if ($sampler ne 'mh' && $sampler ne 'pmmh') {
+    	        warn("--nchains is only available with --sampler mh, ignoring.\n");
+    	        $self->set_named_arg('nchains', 1);
+    	    } elsif ($filter eq 'adaptive' ||
+    	            $self->get_named_arg('resampler') eq 'rejection') {
+    	        warn("--nchains is not available with this filter or resampler, ignoring.\n");
+    	        $self->set_named_arg('nchains', 1);
+    	    }
+    	}
+    	if ($self->get_named_arg('transition-tile') > 0 &&
+    	        ($self->get_named_arg('nchains') > 1 ||
+    	        $self->get_named_arg('with-parallel-theta'))) {
+    	    warn("--transition-tile is not available with --nchains or --with-parallel-theta, ignoring.\n");
+    	    $self->set_named_arg('transition-tile', 0);
+    	}
+    	if ($self->get_named_arg('correlation') != 0.0) {
+    	    my $correlation = $self->get_named_arg('correlation');
+    	    if ($sampler ne 'mh' && $sampler ne 'pmmh') {
+    	        warn("--correlation is only available with --sampler mh, ignoring.\n");
+    	        $self->set_named_arg('correlation', 0.0);
+    	    } elsif ($self->get_named_arg('nchains') > 1) {
+    	        warn("--correlation is not available with --nchains, ignoring.\n");
+    	        $self->set_named_arg('correlation', 0.0);
+    	    } elsif ($self->get_named_arg('resampler') eq 'metropolis') {
+    	        warn("--correlation is not available with --resampler metropolis, ignoring.\n");
+    	        $self->set_named_arg('correlation', 0.0);
+    	    } elsif ($correlation < 0.0 || $correlation >= 1.0) {
+    	        warn("--correlation must be in [0,1), ignoring.\n");
+    	        $self->set_named_arg('correlation', 0.0);
+    	    }
+    	}
     }
     
     $self->{_binary} = 'sample';
@@ -34,9 +34,12 @@ each subsequent size multiples this by two.
 
 Number of trials on each size.
 
+=back
 
+The output file records the time taken by each trial in C<time>, and the
+average time taken by each step of the filter, from one observation to the
+next, in C<latency>. Both are in microseconds, and require C<--enable-timing>.
 
-=back
 
 =cut
 our @CLIENT_OPTIONS = (
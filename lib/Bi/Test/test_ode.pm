@@ -0,0 +1,115 @@
+=head1 NAME
+
+test_ode - test load balancing of ODE integrators.
+
+=head1 SYNOPSIS
+
+    libbi test_ode ...
+
+=head1 INHERITS
+
+L<Bi::Client>
+
+=head1 DESCRIPTION
+
+Repeatedly integrates the C<transition> block of the model for a set of
+trajectories drawn from the C<parameter> and C<initial> blocks, once with a
+single thread, then with all threads for a number of C<--ode-chunk>
+settings. For each setting, the output file contains the time taken on each
+repetition, and the thread utilisation, computed as the single thread time
+over the product of the number of threads and the multithreaded time.
+
+With C<--noutputs>, the time interval is divided into that many equal
+subintervals, integrated one after the other, as between dense output
+times. Compare runs with and without C<--with-ode-dense-output> to measure
+the effect of dense output.
+
+=cut
+
+package Bi::Test::test_ode;
+
+use parent 'Bi::Client';
+use warnings;
+use strict;
+
+=head1 OPTIONS
+
+=over 4
+
+=item C<--start-time> (default 0.0)
+
+Start time.
+
+=item C<--end-time> (default 1.0)
+
+End time.
+
+=item C<--noutputs> (default 0)
+
+Number of dense output times.
+
+=item C<--nparticles> (default 1024)
+
+Number of trajectories.
+
+=item C<--Cs> (default 6)
+
+Number of chunk sizes to use. The first is zero, for the default static
+division of trajectories between threads, then 1, 2, 4, 8, etc.
+
+=item C<--reps> (default 10)
+
+Number of trials on each chunk size.
+
+=back
+
+=cut
+our @CLIENT_OPTIONS = (
+    {
+      name => 'start-time',
+      type => 'float',
+      default => 0.0
+    },
+    {
+      name => 'end-time',
+      type => 'float',
+      default => 1.0
+    },
+    {
+      name => 'noutputs',
+      type => 'int',
+      default => 0
+    },
+    {
+      name => 'nparticles',
+      type => 'int',
+      default => 1024
+    },
+    {
+      name => 'Cs',
+      type => 'int',
+      default => 6
+    },
+    {
+      name => 'reps',
+      type => 'int',
+      default => 10
+    }
+);
+
+sub init {
+    my $self = shift;
+
+	$self->{_binary} = 'test_ode';
+    push(@{$self->{_params}}, @CLIENT_OPTIONS);
+}
+
+1;
+
+=head1 AUTHOR
+
+Lawrence Murray <lawrence.murray@csiro.au>
+
+=head1 VERSION
+
+$Rev$ $Date$
@@ -42,7 +42,25 @@ for a Metropolis resampler (Murray 2011),
 
 =item C<'rejection'>
 
-for a rejection resampler, or
+for a rejection resampler,
+
+=item C<'residual'>
+
+for a residual resampler (Liu & Chen 1998), with the residual offspring
+drawn multinomially,
+
+=item C<'residual-systematic'>
+
+for a residual resampler with the residual offspring drawn systematically,
+
+=item C<'ancestors'>
+
+to time only the conversion of cumulative offspring, from a stratified
+resampler, to permuted ancestors, or
+
+=item C<'permute'>
+
+to time only the permutation of ancestors, from a multinomial resampler.
 
 =back
 
@@ -77,6 +95,13 @@ resampling on CPU when copying weight vectors from GPU.
 
 Divisor under the default number of steps in the Metropolis resampler.
 
+=item C<--copy-width> (default 0)
+
+Number of columns of a state matrix to copy according to the ancestry after
+each resampling, timed separately. Zero to skip the copy. The copy time of
+each trial, and the copy bandwidth in MB/s, counting a read and write of
+each overwritten row, are written to the output file.
+
 =back
 
 =cut
@@ -120,6 +145,11 @@ our @CLIENT_OPTIONS = (
       name => 'C',
       type => 'int',
       default => 1
+    },
+    {
+      name => 'copy-width',
+      type => 'int',
+      default => 0
     }
 );
 
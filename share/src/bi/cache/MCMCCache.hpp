@@ -128,6 +128,18 @@ public:
   template<class M1>
   void writePath(const int p, const M1 X);
 
+  /**
+   * Write the contents of another cache. The samples of the other cache
+   * must follow on from those of this cache, once offset.
+   *
+   * @tparam IO2 Output type of other cache.
+   *
+   * @param offset Offset added to sample indices of the other cache.
+   * @param o Other cache.
+   */
+  template<class IO2>
+  void writeCache(const int offset, const MCMCCache<CL,IO2>& o);
+
   /**
    * Is cache full?
    */
@@ -219,6 +231,9 @@ protected:
    */
   BOOST_SERIALIZATION_SPLIT_MEMBER()
   friend class boost::serialization::access;
+
+  template<Location CL2, class IO2>
+  friend class MCMCCache;
 };
 }
 
@@ -370,6 +385,27 @@ void bi::MCMCCache<CL,IO1>::writePath(const int p, const M1 X) {
   }
 }
 
+template<bi::Location CL, class IO1>
+template<class IO2>
+void bi::MCMCCache<CL,IO1>::writeCache(const int offset,
+    const MCMCCache<CL,IO2>& o) {
+  /* pre-conditions */
+  BI_ASSERT(len == 0 || offset + o.first == first + len);
+  BI_ASSERT(len + o.len <= NUM_SAMPLES);
+  BI_ASSERT(pathCache.size() == o.pathCache.size());
+
+  if (len == 0) {
+    first = offset + o.first;
+  }
+  llCache.set(len, o.len, o.llCache.get(0, o.len));
+  lpCache.set(len, o.len, o.lpCache.get(0, o.len));
+  parameterCache.set(len, o.len, o.parameterCache.get(0, o.len));
+  for (int t = 0; t < int(pathCache.size()); ++t) {
+    pathCache[t]->set(len, o.len, o.pathCache[t]->get(0, o.len));
+  }
+  len += o.len;
+}
+
 template<bi::Location CL, class IO1>
 bool bi::MCMCCache<CL,IO1>::isFull() const {
   return len == NUM_SAMPLES;
@@ -0,0 +1,38 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_CUDA_PRIMITIVE_VECTORPRIMITIVE_CUH
+#define BI_CUDA_PRIMITIVE_VECTORPRIMITIVE_CUH
+
+namespace bi {
+/**
+ * @internal
+ */
+template<>
+struct max_sumexp_reduce_impl<ON_DEVICE> {
+  template<class V1>
+  static void func(const V1 x, typename V1::value_type& mx,
+      typename V1::value_type& sum1, typename V1::value_type& sum2);
+};
+}
+
+template<class V1>
+void bi::max_sumexp_reduce_impl<bi::ON_DEVICE>::func(const V1 x,
+    typename V1::value_type& mx, typename V1::value_type& sum1,
+    typename V1::value_type& sum2) {
+  typedef typename V1::value_type T1;
+
+  thrust::tuple<T1,T1,T1> init(bi::log(static_cast<T1>(0.0)), 0.0, 0.0);
+  thrust::tuple<T1,T1,T1> result = op_reduce(x,
+      nan_max_sumexp_functor<T1>(), init, max_sumexp_functor<T1>());
+
+  mx = thrust::get<0>(result);
+  sum1 = thrust::get<1>(result);
+  sum2 = thrust::get<2>(result);
+}
+
+#endif
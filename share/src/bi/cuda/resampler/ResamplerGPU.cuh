@@ -137,6 +137,11 @@ void bi::ResamplerGPU::permute(V1 as) {
   postPermute(cs, is, as);
 }
 
+template<class V1, class M1>
+void bi::ResamplerGPU::copy(const V1 as, M1 X) {
+  gather_rows(as, X, X);
+}
+
 template<class V1, class V2>
 void bi::ResamplerGPU::prePermute(V1 as, V2 is) {
   /* pre-condition */
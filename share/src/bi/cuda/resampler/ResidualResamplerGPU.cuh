@@ -0,0 +1,33 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_CUDA_RESAMPLER_RESIDUALRESAMPLERGPU_CUH
+#define BI_CUDA_RESAMPLER_RESIDUALRESAMPLERGPU_CUH
+
+#include "../../host/math/temp_vector.hpp"
+
+template<class V1, class V2>
+void bi::ResidualResamplerGPU::offspring(Random& rng, const V1 lws, V2 os,
+    const int n, const bool systematic)
+    throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typedef typename V1::value_type T1;
+
+  /* residual resampling is dominated by the reductions and the single
+   * pass over the weights, so simply run it on host */
+  typename temp_host_vector<T1>::type lws1(lws.size());
+  typename temp_host_vector<int>::type os1(os.size());
+
+  lws1 = lws;
+  synchronize();
+  ResidualResamplerHost::offspring(rng, lws1, os1, n, systematic);
+  os = os1;
+}
+
+#endif
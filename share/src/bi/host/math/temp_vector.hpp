@@ -11,7 +11,7 @@
 #include "vector.hpp"
 #include "../../primitive/pinned_allocator.hpp"
 #include "../../primitive/aligned_allocator.hpp"
-#include "../../primitive/pooled_allocator.hpp"
+#include "../../primitive/arena_allocator.hpp"
 #include "../../primitive/pipelined_allocator.hpp"
 
 namespace bi {
@@ -26,7 +26,7 @@ namespace bi {
  *
  * temp_host_vector is a convenience class for producing vectors in main
  * memory that are suitable for short-term use before destruction. It uses
- * pooled_allocator to reuse allocated buffers, and when GPU devices
+ * arena_allocator to reuse allocated buffers, and when GPU devices
  * are enabled, pinned_allocator for faster copying between host and device.
  */
 template<class T, int size_value = -1, int inc_value = 1>
@@ -34,14 +34,14 @@ struct temp_host_vector {
   /**
    * Allocator type.
    *
-   * Note that, on host, pooled_allocator is slower than std::allocator. It
-   * is in avoiding calls to pinned_allocator (which internally calls
-   * cudaMallocHost) where there are some performance gains.
+   * arena_allocator draws from a free list of the calling thread without
+   * locking or searching, so that temporaries in inner loops do not call
+   * malloc (or cudaMallocHost, via pinned_allocator) once warm.
    */
   #ifdef ENABLE_CUDA
-  typedef pipelined_allocator<pooled_allocator<pinned_allocator<T> > > allocator_type;
+  typedef pipelined_allocator<arena_allocator<pinned_allocator<T> > > allocator_type;
   #else
-  typedef pooled_allocator<aligned_allocator<T> > allocator_type;
+  typedef arena_allocator<aligned_allocator<T> > allocator_type;
   #endif
 
   /**
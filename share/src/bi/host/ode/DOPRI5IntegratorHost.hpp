@@ -8,6 +8,8 @@
 #ifndef BI_HOST_ODE_DOPRI5INTEGRATORHOST_HPP
 #define BI_HOST_ODE_DOPRI5INTEGRATORHOST_HPP
 
+#include "../../traits/block_traits.hpp"
+
 namespace bi {
 /**
  * Dormand-Prince 5(4) integrator.
@@ -27,18 +29,91 @@ public:
    * @param t1 Start of time interval.
    * @param t2 End of time interval.
    * @param[in,out] s State.
+   *
+   * With dense output enabled (see h_ode_set_dense()), steps are not
+   * truncated at @p t2. The last step may pass @p t2, with the state at
+   * @p t2 interpolated using the continuous extension of the method. That
+   * step is kept in State::getCache(), under columns of its own for each
+   * block, so that if the next call starts at @p t2 and the state has not
+   * been changed in the meantime, integration continues from the end of
+   * that step, or, if it also covers the next end time, by interpolation
+   * alone. As the whole state is checked, a block does not continue if
+   * another updates the state between its calls.
    */
   static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      typename State<B,ON_HOST>::matrix_reference_type C);
+
+  /**
+   * Number of variables.
+   */
+  static const int N = block_size<S>::value;
+
+  /**
+   * Number of variables that the state is checked against before
+   * continuing from a previous step.
+   */
+  static const int NS = B::NR + B::ND + B::NDX + B::NP + B::NPX + B::NF;
+
+  /*
+   * Layout of continuation data for each trajectory: flag set when valid,
+   * end time of last update, start and end time of last step, next step
+   * size, previous error factor, dense output coefficients, derivative
+   * and state at end of last step, and copy of the state as left by the
+   * last update.
+   */
+  static const int C_VALID = 0;
+  static const int C_T = 1;
+  static const int C_TOLD = 2;
+  static const int C_TNEW = 3;
+  static const int C_H = 4;
+  static const int C_LOGFACOLD = 5;
+  static const int C_RCONT = 6;
+  static const int C_K = C_RCONT + 5*N;
+  static const int C_X = C_K + N;
+  static const int C_SNAP = C_X + N;
+  static const int NC = C_SNAP + NS;
+
+  /**
+   * Compute dense output coefficients of an accepted step.
+   */
+  template<class V1, class V2>
+  static void dense(const real h, const V1 x0, const V1 x2, const V1 x3,
+      const V1 x4, const V1 x5, const V1 x6, const V1 k1, const V1 k7,
+      V2 c);
+
+  /**
+   * Interpolate state within last step.
+   */
+  template<class V1, class V2>
+  static void interpolate(const real t, const V1 c, V2 x);
+
+  /**
+   * Copy state into continuation data.
+   */
+  template<class V1>
+  static void snapshot(const State<B,ON_HOST>& s, const int p, V1 c);
+
+  /**
+   * Does state match continuation data?
+   */
+  template<class V1>
+  static bool matches(const State<B,ON_HOST>& s, const int p, const V1 c);
 };
 }
 
 #include "DOPRI5VisitorHost.hpp"
 #include "IntegratorConstants.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
-#include "../../traits/block_traits.hpp"
 #include "../../math/view.hpp"
 
 template<class B, class S, class T1>
@@ -47,100 +122,262 @@ void bi::DOPRI5IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
+  typedef typename State<B,ON_HOST>::matrix_reference_type matrix_reference_type;
+
+  /* identifies the continuation data of this block */
+  static const char owner = 0;
+
+  /* continuation data is allocated once, before work is shared, and only
+   * used with dense output */
+  if (h_dense) {
+    if (bi_omp_serial_begin()) {
+      s.getCache(&owner, NC);
+    }
+    bi_omp_serial_end();
+  }
+  matrix_reference_type C(h_dense ? s.getCache(&owner, NC) :
+      matrix_reference_type());
+
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s, C);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s, C);
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::DOPRI5IntegratorHost<B,S,T1>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s,
+    typename State<B,ON_HOST>::matrix_reference_type C) {
   typedef typename temp_host_vector<real>::type vector_type;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef DOPRI5VisitorHost<B,S,S,real,PX,real> Visitor;
 
-  static const int N = block_size<S>::value;
   const int P = s.size();
+  const int chunk = h_ode_chunk(P);
 
-#pragma omp parallel
-  {
-    vector_type x0(N), x1(N), x2(N), x3(N), x4(N), x5(N), x6(N), err(N), k1(
-        N), k7(N);
-    real t, h, e, e2, logfacold, logfac11, fac;
-    int n, id, p;
-    bool k1in;
-    PX pax;
-
-#pragma omp for
-    for (p = 0; p < P; ++p) {
-      t = t1;
-      h = h_h0;
-      logfacold = bi::log(BI_REAL(1.0e-4));
-      k1in = false;
-      n = 0;
-      host_load<B,S>(s, p, x0);
-
-      /* integrate */
-      while (t < t2 && n < h_nsteps) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
-        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-          h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
-          }
-        }
+  vector_type x0(N), x1(N), x2(N), x3(N), x4(N), x5(N), x6(N), err(N), k1(
+      N), k7(N);
+  real t, h, hnext, told, e, e2, logfacold, logfac11, fac;
+  int n, id, p;
+  bool k1in, crossed;
+  PX pax;
 
-        /* stages */
-        Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
-        k1in = true;  // can reuse from previous iteration in future
+#pragma omp for schedule(dynamic, chunk)
+  for (p = 0; p < P; ++p) {
+    t = t1;
+    h = (s.getStep(p) > BI_REAL(0.0)) ? s.getStep(p) : h_h0;
+    logfacold = bi::log(BI_REAL(1.0e-4));
+    k1in = false;
+    crossed = false;
+    n = 0;
+    host_load<B,S>(s, p, x0);
+
+    /* continue from last step of previous update, if possible */
+    if (h_dense && C(p, C_VALID) > BI_REAL(0.0) && C(p, C_T) == t1
+        && matches(s, p, row(C, p))) {
+      if (t2 <= C(p, C_TNEW)) {
+        /* already covered, interpolate */
+        interpolate(t2, row(C, p), x1);
         host_store<B,S>(s, p, x1);
+        C(p, C_T) = t2;
+        snapshot(s, p, row(C, p));
+        continue;
+      }
+      t = C(p, C_TNEW);
+      h = C(p, C_H);
+      logfacold = C(p, C_LOGFACOLD);
+      x0 = subrange(row(C, p), C_X, N);
+      k1 = subrange(row(C, p), C_K, N);
+      k1in = true;
+      host_store<B,S>(s, p, x0);
+    }
+    hnext = h;
+
+    /* integrate */
+    while (t < t2 && n < h_nsteps) {
+      if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+        // step size too small
+      }
+      hnext = h;
+      if (!h_dense && t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+        h = t2 - t;
+        if (h <= BI_REAL(0.0)) {
+          t = t2;
+          break;
+        }
+      }
 
-        Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        host_store<B,S>(s, p, x2);
+      /* stages */
+      Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), k1.buf(), err.buf(), k1in);
+      k1in = true;  // can reuse from previous iteration in future
+      host_store<B,S>(s, p, x1);
 
-        Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        host_store<B,S>(s, p, x3);
+      Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      host_store<B,S>(s, p, x2);
 
-        Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
-        host_store<B,S>(s, p, x4);
+      Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      host_store<B,S>(s, p, x3);
 
-        Visitor::stage5(t, h, s, p, pax, x0.buf(), x5.buf(), x6.buf(), err.buf());
-        host_store<B,S>(s, p, x5);
+      Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf(), x5.buf(), x6.buf(), err.buf());
+      host_store<B,S>(s, p, x4);
 
-        Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+      Visitor::stage5(t, h, s, p, pax, x0.buf(), x5.buf(), x6.buf(), err.buf());
+      host_store<B,S>(s, p, x5);
 
-        /* compute error */
-        Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
-        e2 = 0.0;
-        for (id = 0; id < N; ++id) {
-          e = err(id)*h/(h_atoler + h_rtoler*bi::max(bi::abs(x0(id)), bi::abs(x6(id))));
-          e2 += e*e;
-        }
-        e2 /= N;
-
-        /* accept/reject */
-        if (e2 <= BI_REAL(1.0)) {
-          /* accept */
-          t += h;
-          x0.swap(x6);
-          k1.swap(k7);
+      Visitor::stage6(t, h, s, p, pax, x0.buf(), x6.buf(), err.buf());
+      host_store<B,S>(s, p, x6);
+
+      /* compute error */
+      Visitor::stageErr(t, h, s, p, pax, x0.buf(), x6.buf(), k7.buf(), err.buf());
+      e2 = 0.0;
+      for (id = 0; id < N; ++id) {
+        e = err(id)*h/(h_atoler + h_rtoler*bi::max(bi::abs(x0(id)), bi::abs(x6(id))));
+        e2 += e*e;
+      }
+      e2 /= N;
+
+      /* accept/reject */
+      if (e2 <= BI_REAL(1.0)) {
+        /* accept */
+        if (h_dense && t + h >= t2) {
+          /* last step, keep for interpolation */
+          dense(h, x0, x2, x3, x4, x5, x6, k1, k7, row(C, p));
+          told = t;
+          crossed = true;
         }
-        host_store<B,S>(s, p, x0);
-
-        /* compute next step size */
-        if (t < t2) {
-          logfac11 = h_expo*bi::log(e2);
-          if (e2 > BI_REAL(1.0)) {
-            /* step was rejected */
-            h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
-          } else {
-            /* step was accepted */
-            fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11);  // Lund-stabilization
-            fac = bi::min(h_facr, bi::max(h_facl, fac));// bound
-            h *= fac;
-            logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
-          }
+        t += h;
+        x0.swap(x6);
+        k1.swap(k7);
+      }
+      host_store<B,S>(s, p, x0);
+
+      /* compute next step size */
+      if (t < t2 || crossed) {
+        logfac11 = h_expo*bi::log(e2);
+        if (e2 > BI_REAL(1.0)) {
+          /* step was rejected */
+          h *= bi::max(h_facl, bi::exp(h_logsafe - logfac11));
+        } else {
+          /* step was accepted */
+          fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11);  // Lund-stabilization
+          fac = bi::min(h_facr, bi::max(h_facl, fac));// bound
+          h *= fac;
+          logfacold = BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)));
         }
+      }
+
+      ++n;
+    }
 
-        ++n;
+    if (crossed) {
+      /* keep last step for next update, interpolate state at end time */
+      C(p, C_VALID) = BI_REAL(1.0);
+      C(p, C_T) = t2;
+      C(p, C_TOLD) = told;
+      C(p, C_TNEW) = t;
+      C(p, C_H) = h;
+      C(p, C_LOGFACOLD) = logfacold;
+      subrange(row(C, p), C_X, N) = x0;
+      subrange(row(C, p), C_K, N) = k1;
+      interpolate(t2, row(C, p), x1);
+      host_store<B,S>(s, p, x1);
+      snapshot(s, p, row(C, p));
+      s.getStep(p) = h;
+    } else {
+      if (h_dense) {
+        C(p, C_VALID) = BI_REAL(0.0);
       }
+
+      /* keep unclipped step size for next update */
+      s.getStep(p) = hnext;
+    }
+  }
+}
+
+template<class B, class S, class T1>
+template<class V1, class V2>
+void bi::DOPRI5IntegratorHost<B,S,T1>::dense(const real h, const V1 x0,
+    const V1 x2, const V1 x3, const V1 x4, const V1 x5, const V1 x6,
+    const V1 k1, const V1 k7, V2 c) {
+  /* coefficients of the continuous extension (Hairer, Norsett & Wanner
+   * 1993, sec. II.6), in terms of stage values rather than stage
+   * derivatives, as only the former are kept */
+  const real d1 = BI_REAL(-478460375.0/176282538.0);
+  const real d2 = BI_REAL(1519821236000.0/98101232397.0);
+  const real d3 = BI_REAL(7667767875.0/470086768.0);
+  const real d4 = BI_REAL(-386757729585.0/49829197408.0);
+  const real d5 = BI_REAL(623105010.0/205662961.0);
+  const real d6 = BI_REAL(-396506505.0/29380423.0);
+  const real d7 = BI_REAL(69997945.0/29380423.0);
+
+  real ydiff, bspl;
+  int id;
+  for (id = 0; id < N; ++id) {
+    ydiff = x6(id) - x0(id);
+    bspl = h*k1(id) - ydiff;
+    c(C_RCONT + id) = x0(id);
+    c(C_RCONT + N + id) = ydiff;
+    c(C_RCONT + 2*N + id) = bspl;
+    c(C_RCONT + 3*N + id) = ydiff - h*k7(id) - bspl;
+    c(C_RCONT + 4*N + id) = h*(d1*k1(id) + d7*k7(id)) + d2*(x2(id) - x0(id))
+        + d3*(x3(id) - x0(id)) + d4*(x4(id) - x0(id))
+        + d5*(x5(id) - x0(id)) + d6*(x6(id) - x0(id));
+  }
+}
+
+template<class B, class S, class T1>
+template<class V1, class V2>
+void bi::DOPRI5IntegratorHost<B,S,T1>::interpolate(const real t,
+    const V1 c, V2 x) {
+  const real theta = (t - c(C_TOLD))/(c(C_TNEW) - c(C_TOLD));
+  const real theta1 = BI_REAL(1.0) - theta;
+
+  int id;
+  for (id = 0; id < N; ++id) {
+    x(id) = c(C_RCONT + id) + theta*(c(C_RCONT + N + id) + theta1*(c(C_RCONT + 2*N + id)
+        + theta*(c(C_RCONT + 3*N + id) + theta1*c(C_RCONT + 4*N + id))));
+  }
+}
+
+template<class B, class S, class T1>
+template<class V1>
+void bi::DOPRI5IntegratorHost<B,S,T1>::snapshot(const State<B,ON_HOST>& s,
+    const int p, V1 c) {
+  subrange(c, C_SNAP, B::NR + B::ND) = row(s.getDyn(), p);
+  subrange(c, C_SNAP + B::NR + B::ND, B::NDX) = row(s.get(DX_VAR), p);
+  subrange(c, C_SNAP + B::NR + B::ND + B::NDX, B::NP + B::NPX + B::NF) =
+      row(columns(s.getCommon(), 0, B::NP + B::NPX + B::NF), 0);
+}
+
+template<class B, class S, class T1>
+template<class V1>
+bool bi::DOPRI5IntegratorHost<B,S,T1>::matches(const State<B,ON_HOST>& s,
+    const int p, const V1 c) {
+  BOOST_AUTO(dyn, row(s.getDyn(), p));
+  BOOST_AUTO(dx, row(s.get(DX_VAR), p));
+  BOOST_AUTO(com, row(s.getCommon(), 0));
+  int i, j = C_SNAP;
+
+  for (i = 0; i < dyn.size(); ++i, ++j) {
+    if (dyn(i) != c(j)) {
+      return false;
+    }
+  }
+  for (i = 0; i < dx.size(); ++i, ++j) {
+    if (dx(i) != c(j)) {
+      return false;
+    }
+  }
+  for (i = 0; i < B::NP + B::NPX + B::NF; ++i, ++j) {
+    if (com(i) != c(j)) {
+      return false;
     }
   }
+  return true;
 }
 
 #endif
@@ -8,6 +8,7 @@
 #include "IntegratorConstants.hpp"
 
 #include "../../math/function.hpp"
+#include "../../misc/omp.hpp"
 
 real h_h0;
 real h_rtoler;
@@ -18,6 +19,8 @@ real h_facl;
 real h_facr;
 int h_nsteps;
 real h_beta;
+int h_chunk;
+bool h_dense;
 real h_expo1;
 real h_expo;
 real h_facc1;
@@ -76,6 +79,27 @@ void h_ode_set_nsteps(const int nstepsin) {
   h_nsteps = nstepsin;
 }
 
+void h_ode_set_chunk(const int chunkin) {
+  /* pre-condition */
+  BI_ASSERT(chunkin >= 0);
+
+  h_chunk = chunkin;
+}
+
+int h_ode_chunk(const int P, const int inc) {
+  int chunk;
+  if (h_chunk > 0) {
+    chunk = (h_chunk + inc - 1)/inc;
+  } else {
+    chunk = (P/inc + bi_omp_max_threads - 1)/bi_omp_max_threads;
+  }
+  return bi::max(chunk, 1);
+}
+
+void h_ode_set_dense(const bool densein) {
+  h_dense = densein;
+}
+
 void h_ode_init() {
   h_ode_set_h0(BI_REAL(1.0e-2));
   h_ode_set_rtoler(BI_REAL(1.0e-7));
@@ -86,4 +110,6 @@ void h_ode_init() {
   h_ode_set_facr(BI_REAL(10.0));
   h_ode_set_beta(BI_REAL(0.04));
   h_ode_set_nsteps(1000);
+  h_ode_set_chunk(0);
+  h_ode_set_dense(false);
 }
@@ -80,6 +80,22 @@ extern int h_nsteps;
  */
 extern real h_beta;
 
+/**
+ * @internal
+ *
+ * Number of trajectories per chunk when dynamically scheduling trajectories
+ * across threads. Zero for static scheduling.
+ */
+extern int h_chunk;
+
+/**
+ * @internal
+ *
+ * Use dense output, so that integration may continue past the end of one
+ * time interval into the next without truncating steps.
+ */
+extern bool h_dense;
+
 /*
  * Precalculations.
  */
@@ -165,6 +181,34 @@ void h_ode_set_facr(const real facrin);
  */
 void h_ode_set_nsteps(const int nstepsin);
 
+/**
+ * Set number of trajectories per chunk when dynamically scheduling
+ * trajectories across threads. Zero for static scheduling.
+ *
+ * @ingroup method_updater
+ */
+void h_ode_set_chunk(const int chunkin);
+
+/**
+ * Chunk size for scheduling a loop over trajectories across threads.
+ *
+ * @ingroup method_updater
+ *
+ * @param P Number of trajectories.
+ * @param inc Number of trajectories per loop iteration.
+ *
+ * @return Number of loop iterations per chunk. Under static scheduling, this
+ * divides the iterations evenly between threads.
+ */
+int h_ode_chunk(const int P, const int inc = 1);
+
+/**
+ * Enable or disable dense output.
+ *
+ * @ingroup method_updater
+ */
+void h_ode_set_dense(const bool densein);
+
 #ifdef __CUDACC__
 #include "../../cuda/ode/IntegratorConstants.cuh"
 #endif
@@ -29,12 +29,19 @@ public:
    * @param[in,out] s State.
    */
   static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
 #include "RK4VisitorHost.hpp"
 #include "IntegratorConstants.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../typelist/front.hpp"
 #include "../../typelist/pop_front.hpp"
@@ -47,6 +54,19 @@ void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::RK4IntegratorHost<B,S,T1>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
   typedef typename temp_host_vector<real>::type vector_type;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef RK4VisitorHost<B,S,S,real,PX,real> Visitor;
@@ -54,49 +74,46 @@ void bi::RK4IntegratorHost<B,S,T1>::update(const T1 t1, const T1 t2,
   static const int N = block_size<S>::value;
   const int P = s.size();
 
-  #pragma omp parallel
-  {
-    vector_type x0(N), x1(N), x2(N), x3(N), x4(N);
-    real t, h;
-    int p;
-    PX pax;
-
-    #pragma omp for
-    for (p = 0; p < P; ++p) {
-      t = t1;
-      h = h_h0;
-      host_load<B,S>(s, p, x0);
-
-      /* integrate */
-      while (t < t2) {
-        /* initialise */
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
-        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-          h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
-          }
+  vector_type x0(N), x1(N), x2(N), x3(N), x4(N);
+  real t, h;
+  int p;
+  PX pax;
+
+  #pragma omp for
+  for (p = 0; p < P; ++p) {
+    t = t1;
+    h = h_h0;
+    host_load<B,S>(s, p, x0);
+
+    /* integrate */
+    while (t < t2) {
+      /* initialise */
+      if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+        // step size too small
+      }
+      if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+        h = t2 - t;
+        if (h <= BI_REAL(0.0)) {
+          t = t2;
+          break;
         }
+      }
 
-        /* stages */
-        Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf());
-        host_store<B,S>(s, p, x1);
+      /* stages */
+      Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf());
+      host_store<B,S>(s, p, x1);
 
-        Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf());
-        host_store<B,S>(s, p, x2);
+      Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf());
+      host_store<B,S>(s, p, x2);
 
-        Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf());
-        host_store<B,S>(s, p, x3);
+      Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf());
+      host_store<B,S>(s, p, x3);
 
-        Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf());
-        host_store<B,S>(s, p, x4);
+      Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf());
+      host_store<B,S>(s, p, x4);
 
-        x0.swap(x4);
-        t += h;
-      }
+      x0.swap(x4);
+      t += h;
     }
   }
 }
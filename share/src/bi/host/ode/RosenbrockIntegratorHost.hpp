@@ -0,0 +1,274 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROSENBROCKINTEGRATORHOST_HPP
+#define BI_HOST_ODE_ROSENBROCKINTEGRATORHOST_HPP
+
+namespace bi {
+/**
+ * Rosenbrock integrator.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam X Block type, providing jacobian().
+ * @tparam T1 Scalar type.
+ *
+ * Implements the three stage, L-stable ROS3 method of order 3(2) described
+ * in @ref Sandu1997 "Sandu et al. (1997)", with adaptive step size control.
+ * The Jacobian is evaluated once at the start of each step, and is reused
+ * over rejected steps. The system is treated as autonomous over each step,
+ * i.e. the partial derivative of the time derivatives with respect to time
+ * is taken to be zero.
+ */
+template<class B, class S, class X, class T1>
+class RosenbrockIntegratorHost {
+public:
+  /**
+   * Integrate.
+   *
+   * @param t1 Start of time interval.
+   * @param t2 End of time interval.
+   * @param[in,out] s State.
+   */
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * Construct the iteration matrix \f$I/(\gamma h) - J\f$ and compute its
+   * LU decomposition, with partial pivoting, in place.
+   *
+   * @param h Step size.
+   * @param J Jacobian, column major.
+   * @param[out] A LU decomposition of the iteration matrix, column major.
+   * @param[out] piv Pivots.
+   */
+  static void factor(const T1 h, const real* J, real* A, int* piv);
+
+  /**
+   * Solve linear system using LU decomposition from factor().
+   *
+   * @param A LU decomposition.
+   * @param piv Pivots.
+   * @param[in,out] b On input, right hand side, on output, solution.
+   */
+  static void solve(const real* A, const int* piv, real* b);
+};
+}
+
+#include "RosenbrockVisitorHost.hpp"
+#include "IntegratorConstants.hpp"
+#include "../host.hpp"
+#include "../../misc/omp.hpp"
+#include "../../ode/RosenbrockStage.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+#include "../../traits/block_traits.hpp"
+#include "../../math/view.hpp"
+#include "../../math/temp_vector.hpp"
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorHost<B,S,X,T1>::update(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorHost<B,S,X,T1>::updateTeam(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  typedef typename temp_host_vector<real>::type vector_type;
+  typedef typename temp_host_vector<int>::type int_vector_type;
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef RosenbrockVisitorHost<B,S,S,real,PX,real> Visitor;
+  typedef RosenbrockStage<real,real> stage;
+
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+  const int chunk = h_ode_chunk(P);
+
+  vector_type x0(N), x1(N), f0(N), f(N), k1(N), k2(N), k3(N), err(N),
+      J(N*N), A(N*N);
+  int_vector_type piv(N);
+  real t, h, hnext, e, e2, fac;
+  int n, id, p;
+  bool fresh;
+  PX pax;
+
+  #pragma omp for schedule(dynamic, chunk)
+  for (p = 0; p < P; ++p) {
+    t = t1;
+    h = (s.getStep(p) > BI_REAL(0.0)) ? s.getStep(p) : h_h0;
+    hnext = h;
+    fresh = false;
+    n = 0;
+    host_load<B,S>(s, p, x0);
+
+    /* integrate */
+    while (t < t2 && n < h_nsteps) {
+      hnext = h;
+      if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+        h = t2 - t;
+        if (h <= BI_REAL(0.0)) {
+          t = t2;
+          break;
+        }
+      }
+
+      /* derivatives and Jacobian at start of step, kept over rejections */
+      if (!fresh) {
+        Visitor::dfdt(t, s, p, pax, f0.buf());
+        J.clear();
+        X::jacobian(t, s, p, pax, J.buf());
+        fresh = true;
+      }
+      factor(h, J.buf(), A.buf(), piv.buf());
+
+      /* stages */
+      k1 = f0;
+      solve(A.buf(), piv.buf(), k1.buf());
+      for (id = 0; id < N; ++id) {
+        stage::stage1(x0(id), k1(id), x1(id));
+      }
+      host_store<B,S>(s, p, x1);
+
+      Visitor::dfdt(stage::time2(t, h), s, p, pax, f.buf());
+      for (id = 0; id < N; ++id) {
+        stage::stage2(h, f(id), k1(id), k2(id));
+      }
+      solve(A.buf(), piv.buf(), k2.buf());
+
+      for (id = 0; id < N; ++id) {
+        stage::stage3(h, f(id), k1(id), k2(id), k3(id));
+      }
+      solve(A.buf(), piv.buf(), k3.buf());
+
+      /* compute solution and error */
+      e2 = BI_REAL(0.0);
+      for (id = 0; id < N; ++id) {
+        stage::stageErr(x0(id), k1(id), k2(id), k3(id), x1(id), err(id));
+        e = err(id)/(h_atoler + h_rtoler*bi::max(bi::abs(x0(id)), bi::abs(x1(id))));
+        e2 += e*e;
+      }
+      e2 /= N;
+
+      if (e2 <= BI_REAL(1.0)) {
+        /* accept */
+        t += h;
+        x0 = x1;
+        fresh = false;
+        host_store<B,S>(s, p, x1);
+      } else {
+        /* reject */
+        host_store<B,S>(s, p, x0);
+      }
+
+      /* compute next step size, error is of order 3 in h */
+      if (t < t2) {
+        fac = bi::exp(h_logsafe - BI_REAL(1.0/6.0)*bi::log(e2));
+        fac = bi::min(h_facr, bi::max(h_facl, fac)); // bound
+        h *= fac;
+      }
+
+      ++n;
+    }
+
+    /* keep unclipped step size for next update */
+    s.getStep(p) = hnext;
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorHost<B,S,X,T1>::factor(const T1 h,
+    const real* J, real* A, int* piv) {
+  typedef RosenbrockStage<real,real> stage;
+  static const int N = block_size<S>::value;
+
+  const real d = stage::shift(h);
+  real a, amax;
+  int i, j, k;
+
+  for (j = 0; j < N; ++j) {
+    for (i = 0; i < N; ++i) {
+      A[i + N*j] = -J[i + N*j];
+    }
+    A[j + N*j] += d;
+  }
+
+  for (k = 0; k < N; ++k) {
+    /* pivot */
+    piv[k] = k;
+    amax = bi::abs(A[k + N*k]);
+    for (i = k + 1; i < N; ++i) {
+      if (bi::abs(A[i + N*k]) > amax) {
+        amax = bi::abs(A[i + N*k]);
+        piv[k] = i;
+      }
+    }
+    if (piv[k] != k) {
+      for (j = 0; j < N; ++j) {
+        a = A[k + N*j];
+        A[k + N*j] = A[piv[k] + N*j];
+        A[piv[k] + N*j] = a;
+      }
+    }
+
+    /* eliminate */
+    for (i = k + 1; i < N; ++i) {
+      A[i + N*k] /= A[k + N*k];
+      for (j = k + 1; j < N; ++j) {
+        A[i + N*j] -= A[i + N*k]*A[k + N*j];
+      }
+    }
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorHost<B,S,X,T1>::solve(const real* A,
+    const int* piv, real* b) {
+  static const int N = block_size<S>::value;
+
+  real a;
+  int i, k;
+
+  for (k = 0; k < N; ++k) {
+    if (piv[k] != k) {
+      a = b[k];
+      b[k] = b[piv[k]];
+      b[piv[k]] = a;
+    }
+  }
+  for (k = 0; k < N; ++k) {
+    for (i = k + 1; i < N; ++i) {
+      b[i] -= A[i + N*k]*b[k];
+    }
+  }
+  for (k = N - 1; k >= 0; --k) {
+    b[k] /= A[k + N*k];
+    for (i = 0; i < k; ++i) {
+      b[i] -= A[i + N*k]*b[k];
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_ODE_ROSENBROCKVISITORHOST_HPP
+#define BI_HOST_ODE_ROSENBROCKVISITORHOST_HPP
+
+namespace bi {
+/**
+ * Visitor for RosenbrockIntegrator.
+ *
+ * @tparam B Model type.
+ * @tparam S1 Action type list.
+ * @tparam S2 Action type list.
+ * @tparam T1 Scalar type.
+ * @tparam PX Parents type.
+ * @tparam T2 Scalar type.
+ */
+template<class B, class S1, class S2, class T1, class PX, class T2>
+class RosenbrockVisitorHost {
+public:
+  /**
+   * Evaluate time derivatives of all targets.
+   */
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    coord_type cox;
+    int id = start;
+
+    while (id < end) {
+      front::dfdt(t, s, p, cox, pax, f[id]);
+      ++cox;
+      ++id;
+    }
+    visitor::dfdt(t, s, p, pax, f);
+  }
+
+private:
+  typedef typename front<S2>::type front;
+  typedef typename pop_front<S2>::type pop_front;
+  typedef typename front::coord_type coord_type;
+
+  typedef RosenbrockVisitorHost<B,S1,pop_front,T1,PX,T2> visitor;
+
+  static const int start = action_start<S1,front>::value;
+  static const int end = action_end<S1,front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of RosenbrockVisitorHost.
+ */
+template<class B, class S1, class T1, class PX, class T2>
+class RosenbrockVisitorHost<B,S1,empty_typelist,T1,PX,T2> {
+public:
+  static void dfdt(const T1 t, const State<B,ON_HOST>& s, const int p,
+      const PX& pax, T2* f) {
+    //
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_PRIMITIVE_VECTORPRIMITIVE_HPP
+#define BI_HOST_PRIMITIVE_VECTORPRIMITIVE_HPP
+
+#include <vector>
+
+namespace bi {
+/**
+ * Streaming accumulator for max_sumexp_reduce(), on host.
+ *
+ * @ingroup primitive_vector
+ *
+ * @tparam T1 Scalar type.
+ *
+ * Each thread accumulates its own elements with add(), then the
+ * per-thread accumulators are merged with combine(). This allows the
+ * reduction to be fused into other passes over the same elements, such
+ * as the evaluation of log-densities.
+ */
+template<class T1>
+struct max_sumexp_accumulator {
+  /**
+   * Constructor.
+   */
+  max_sumexp_accumulator();
+
+  /**
+   * Accumulate element.
+   *
+   * @param x Element. NaN and \f$-\infty\f$ do not contribute.
+   */
+  void add(const T1 x);
+
+  /**
+   * Merge another accumulator into this one.
+   *
+   * @param o Accumulator.
+   */
+  void combine(const max_sumexp_accumulator<T1>& o);
+
+  /**
+   * \f$y\f$, maximum so far.
+   */
+  T1 mx;
+
+  /**
+   * \f$\sum_i \exp(x_i - y)\f$ so far.
+   */
+  T1 sum1;
+
+  /**
+   * \f$\sum_i \exp(2(x_i - y))\f$ so far.
+   */
+  T1 sum2;
+};
+
+/**
+ * Combine the accumulators of all threads of the current team, in thread
+ * order, so that the result is reproducible.
+ *
+ * @ingroup primitive_vector
+ *
+ * @tparam T1 Scalar type.
+ *
+ * @param acc Accumulator of the calling thread.
+ * @param[out] mx \f$y\f$.
+ * @param[out] sum1 \f$\sum_i \exp(x_i - y)\f$.
+ * @param[out] sum2 \f$\sum_i \exp(2(x_i - y))\f$.
+ *
+ * To be called by every thread of the team, all of which receive the
+ * result.
+ */
+template<class T1>
+void max_sumexp_combine_team(const max_sumexp_accumulator<T1>& acc,
+    T1& mx, T1& sum1, T1& sum2);
+
+/**
+ * @internal
+ */
+template<>
+struct max_sumexp_reduce_impl<ON_HOST> {
+  template<class V1>
+  static void func(const V1 x, typename V1::value_type& mx,
+      typename V1::value_type& sum1, typename V1::value_type& sum2);
+};
+}
+
+#include "../../math/function.hpp"
+#include "../../misc/omp.hpp"
+
+template<class T1>
+inline bi::max_sumexp_accumulator<T1>::max_sumexp_accumulator() :
+    mx(bi::log(static_cast<T1>(0.0))), sum1(0.0), sum2(0.0) {
+  //
+}
+
+template<class T1>
+inline void bi::max_sumexp_accumulator<T1>::add(const T1 x) {
+  T1 z;
+  if (x > mx) {
+    /* new maximum, rescale partial sums */
+    z = bi::exp(mx - x);
+    sum1 = sum1*z + 1.0;
+    sum2 = sum2*z*z + 1.0;
+    mx = x;
+  } else if (x > bi::log(static_cast<T1>(0.0))) {  // excludes NaN
+    z = bi::exp(x - mx);
+    sum1 += z;
+    sum2 += z*z;
+  }
+}
+
+template<class T1>
+inline void bi::max_sumexp_accumulator<T1>::combine(
+    const max_sumexp_accumulator<T1>& o) {
+  T1 z;
+  if (o.mx > mx) {
+    z = bi::exp(mx - o.mx);
+    sum1 = sum1*z + o.sum1;
+    sum2 = sum2*z*z + o.sum2;
+    mx = o.mx;
+  } else if (o.sum1 > 0.0) {
+    z = bi::exp(o.mx - mx);
+    sum1 += o.sum1*z;
+    sum2 += o.sum2*z*z;
+  }
+}
+
+template<class T1>
+void bi::max_sumexp_combine_team(const max_sumexp_accumulator<T1>& acc,
+    T1& mx, T1& sum1, T1& sum2) {
+  std::vector<max_sumexp_accumulator<T1> >* accs;
+  max_sumexp_accumulator<T1> acc1;
+  int t;
+
+  /* one slot for each thread, shared by the team */
+  #pragma omp single copyprivate(accs)
+  accs = new std::vector<max_sumexp_accumulator<T1> >(bi_omp_max_threads);
+
+  (*accs)[bi_omp_tid] = acc;
+  #pragma omp barrier
+  for (t = 0; t < bi_omp_max_threads; ++t) {
+    acc1.combine((*accs)[t]);
+  }
+  mx = acc1.mx;
+  sum1 = acc1.sum1;
+  sum2 = acc1.sum2;
+
+  #pragma omp barrier
+  #pragma omp single
+  delete accs;
+}
+
+template<class V1>
+void bi::max_sumexp_reduce_impl<bi::ON_HOST>::func(const V1 x,
+    typename V1::value_type& mx, typename V1::value_type& sum1,
+    typename V1::value_type& sum2) {
+  typedef typename V1::value_type T1;
+
+  if (bi_omp_team) {
+    max_sumexp_accumulator<T1> acc1;
+    int i;
+
+    #pragma omp for
+    for (i = 0; i < x.size(); ++i) {
+      acc1.add(x(i));
+    }
+    max_sumexp_combine_team(acc1, mx, sum1, sum2);
+    return;
+  }
+
+  std::vector<max_sumexp_accumulator<T1> > accs(bi_omp_max_threads);
+  max_sumexp_accumulator<T1> acc;
+  int t;
+
+  #pragma omp parallel
+  {
+    max_sumexp_accumulator<T1> acc1;
+    int i;
+
+    #pragma omp for
+    for (i = 0; i < x.size(); ++i) {
+      acc1.add(x(i));
+    }
+    accs[bi_omp_tid] = acc1;
+  }
+
+  /* combine in thread order, so that the result is reproducible */
+  for (t = 0; t < bi_omp_max_threads; ++t) {
+    acc.combine(accs[t]);
+  }
+  mx = acc.mx;
+  sum1 = acc.sum1;
+  sum2 = acc.sum2;
+}
+
+#endif
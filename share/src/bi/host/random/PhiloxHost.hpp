@@ -0,0 +1,232 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_RANDOM_PHILOXHOST_HPP
+#define BI_HOST_RANDOM_PHILOXHOST_HPP
+
+#include "boost/cstdint.hpp"
+
+namespace bi {
+class ReplayStream;
+
+/**
+ * Counter-based pseudorandom number generator, on host.
+ *
+ * @ingroup math_rng
+ *
+ * Implements the Philox-4x32-10 algorithm of @ref Salmon2011
+ * "Salmon et al. (2011)". Each block of four 32-bit variates is a
+ * bijection of a 128-bit counter under a 64-bit key, so that there is no
+ * state other than the key and counter, and any position in any stream can
+ * be reached in constant time.
+ *
+ * The counter is divided into a 64-bit stream number, a 32-bit substream
+ * number and a 32-bit position within that substream. Generators with the
+ * same key but different stream or substream numbers produce independent
+ * sequences. This is used to give each element of a bulk operation its own
+ * sequence, so that the variates drawn for an element do not depend on
+ * which thread draws them.
+ *
+ * Satisfies the requirements of a uniform random number generator for
+ * Boost.Random.
+ *
+ * A ReplayStream may be set, in which case variates are drawn from it
+ * instead, by counter. The stream is kept by copies of the generator, so
+ * that it is used by all generators forked from one that has it set.
+ */
+class PhiloxHost {
+public:
+  /**
+   * Type of variates.
+   */
+  typedef boost::uint32_t result_type;
+
+  BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+  /**
+   * Default constructor. Zero key and counter.
+   */
+  PhiloxHost();
+
+  /**
+   * Seed generator. Sets the key and resets the counter.
+   *
+   * @param seed Seed value.
+   * @param id Second key word, e.g. process number.
+   */
+  void seed(const unsigned seed, const unsigned id = 0);
+
+  /**
+   * Select stream. Resets the position to the start of the stream.
+   *
+   * @param s Stream number.
+   * @param ss Substream number.
+   */
+  void stream(const boost::uint64_t s, const boost::uint32_t ss = 0);
+
+  /**
+   * Generate variate.
+   */
+  result_type operator()();
+
+  /**
+   * Smallest variate.
+   */
+  static result_type min();
+
+  /**
+   * Largest variate.
+   */
+  static result_type max();
+
+  /**
+   * Set replayable stream.
+   *
+   * @param replay The stream, or @c NULL to draw from this generator again.
+   */
+  void setReplay(ReplayStream* replay);
+
+  /**
+   * Get replayable stream, @c NULL if not set.
+   */
+  ReplayStream* getReplay() const;
+
+  /**
+   * Compute the block of variates for a key and counter.
+   *
+   * @param key Key.
+   * @param ctr Counter.
+   * @param[out] out Variates.
+   */
+  static void bijection(const boost::uint32_t key[2],
+      const boost::uint32_t ctr[4], boost::uint32_t out[4]);
+
+private:
+  /**
+   * Generate the next block of variates from the counter, and increment the
+   * counter.
+   */
+  void generate();
+
+  /**
+   * Key.
+   */
+  boost::uint32_t key[2];
+
+  /**
+   * Counter. The first word is the position in the substream, the second
+   * the substream number, and the third and fourth the stream number.
+   */
+  boost::uint32_t ctr[4];
+
+  /**
+   * Current block of variates.
+   */
+  boost::uint32_t buf[4];
+
+  /**
+   * Number of variates used from the current block.
+   */
+  int pos;
+
+  /**
+   * Replayable stream.
+   */
+  ReplayStream* replay;
+};
+}
+
+#include "../../random/ReplayStream.hpp"
+
+inline bi::PhiloxHost::PhiloxHost() : pos(4), replay(NULL) {
+  key[0] = 0;
+  key[1] = 0;
+  ctr[0] = 0;
+  ctr[1] = 0;
+  ctr[2] = 0;
+  ctr[3] = 0;
+}
+
+inline void bi::PhiloxHost::seed(const unsigned seed, const unsigned id) {
+  key[0] = seed;
+  key[1] = id;
+  stream(0, 0);
+}
+
+inline void bi::PhiloxHost::stream(const boost::uint64_t s,
+    const boost::uint32_t ss) {
+  ctr[0] = 0;
+  ctr[1] = ss;
+  ctr[2] = static_cast<boost::uint32_t>(s);
+  ctr[3] = static_cast<boost::uint32_t>(s >> 32);
+  pos = 4;
+}
+
+inline bi::PhiloxHost::result_type bi::PhiloxHost::operator()() {
+  if (pos == 4) {
+    generate();
+    pos = 0;
+  }
+  return buf[pos++];
+}
+
+inline bi::PhiloxHost::result_type bi::PhiloxHost::min() {
+  return 0;
+}
+
+inline bi::PhiloxHost::result_type bi::PhiloxHost::max() {
+  return 0xFFFFFFFFu;
+}
+
+inline void bi::PhiloxHost::setReplay(ReplayStream* replay) {
+  this->replay = replay;
+}
+
+inline bi::ReplayStream* bi::PhiloxHost::getReplay() const {
+  return replay;
+}
+
+inline void bi::PhiloxHost::bijection(const boost::uint32_t key[2],
+    const boost::uint32_t ctr[4], boost::uint32_t out[4]) {
+  static const boost::uint32_t M0 = 0xD2511F53u;
+  static const boost::uint32_t M1 = 0xCD9E8D57u;
+  static const boost::uint32_t W0 = 0x9E3779B9u;
+  static const boost::uint32_t W1 = 0xBB67AE85u;
+
+  boost::uint32_t k0 = key[0], k1 = key[1];
+  boost::uint32_t x0 = ctr[0], x1 = ctr[1], x2 = ctr[2], x3 = ctr[3];
+  boost::uint64_t p0, p1;
+  int round;
+
+  for (round = 0; round < 10; ++round) {
+    p0 = static_cast<boost::uint64_t>(M0)*x0;
+    p1 = static_cast<boost::uint64_t>(M1)*x2;
+    x0 = static_cast<boost::uint32_t>(p1 >> 32) ^ x1 ^ k0;
+    x2 = static_cast<boost::uint32_t>(p0 >> 32) ^ x3 ^ k1;
+    x1 = static_cast<boost::uint32_t>(p1);
+    x3 = static_cast<boost::uint32_t>(p0);
+    k0 += W0;
+    k1 += W1;
+  }
+  out[0] = x0;
+  out[1] = x1;
+  out[2] = x2;
+  out[3] = x3;
+}
+
+inline void bi::PhiloxHost::generate() {
+  if (replay == NULL) {
+    bijection(key, ctr, buf);
+  } else {
+    replay->generate(key, ctr, buf);
+  }
+
+  /* increment position in substream */
+  ++ctr[0];
+}
+
+#endif
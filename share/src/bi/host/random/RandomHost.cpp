@@ -12,18 +12,23 @@
 #endif
 
 void bi::RandomHost::seeds(Random& rng, const unsigned seed) {
-  #pragma omp parallel
-  {
-    #ifdef ENABLE_MPI
-    boost::mpi::communicator world;
-    const int rank = world.rank();
-    const int size = world.size();
+  #ifdef ENABLE_MPI
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  #else
+  const int rank = 0;
+  #endif
 
-    int s = seed*size*bi_omp_max_threads + rank*bi_omp_max_threads + bi_omp_tid;
-    #else
-    int s = seed*bi_omp_max_threads + bi_omp_tid;
-    #endif
+  /* common generator for bulk operations, independent of thread count */
+  rng.hostCommonRng->seed(seed, rank);
+  *rng.hostCommonStream = 0;
 
-    rng.getHostRng().seed(s);
+  /* per-thread generators, on streams with the top bit set so as not to
+   * collide with those of bulk operations */
+  #pragma omp parallel
+  {
+    RngHost& rng1 = rng.getHostRng();
+    rng1.seed(seed, rank);
+    rng1.stream((static_cast<boost::uint64_t>(1) << 63) | bi_omp_tid);
   }
 }
@@ -73,19 +73,20 @@ void bi::RandomHost::uniforms(Random& rng, V1 x,
   typedef typename V1::value_type T1;
   typedef boost::uniform_real<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const boost::uint64_t s = rng.nextHostStream();
 
+  #pragma omp parallel
+  {
     dist_type dist(lower, upper);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+    int j;
 
-    //#pragma omp for
+    #pragma omp for schedule(static)
     for (j = 0; j < x.size(); ++j) {
+      RngHost rng1(rng.getHostStream(s, j));
+      boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
       x(j) = gen();
     }
-    //}
+  }
 }
 
 template<class V1>
@@ -97,19 +98,22 @@ void bi::RandomHost::gaussians(Random& rng, V1 x,
   typedef typename V1::value_type T1;
   typedef boost::normal_distribution<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const boost::uint64_t s = rng.nextHostStream();
 
-    dist_type dist(mu, sigma);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+  #pragma omp parallel
+  {
+    int j;
 
-    //#pragma omp for schedule(static)
+    #pragma omp for schedule(static)
     for (j = 0; j < x.size(); ++j) {
+      /* distribution is per element, as it caches the second variate of
+       * each pair */
+      RngHost rng1(rng.getHostStream(s, j));
+      dist_type dist(mu, sigma);
+      boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
       x(j) = gen();
     }
-  //}
+  }
 }
 
 template<class V1>
@@ -118,22 +122,17 @@ void bi::RandomHost::gammas(Random& rng, V1 x,
   /* pre-condition */
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
-  typedef typename V1::value_type T1;
-  typedef boost::gamma_distribution<T1> dist_type;
+  const boost::uint64_t s = rng.nextHostStream();
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
+  #pragma omp parallel
+  {
     int j;
 
-    dist_type dist(alpha);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
-
-    //#pragma omp for schedule(static)
+    #pragma omp for schedule(static)
     for (j = 0; j < x.size(); ++j) {
-      x(j) = beta*gen();
+      x(j) = rng.getHostStream(s, j).gamma(alpha, beta);
     }
-    //}
+  }
 }
 
 template<class V1>
@@ -143,25 +142,23 @@ void bi::RandomHost::betas(Random& rng, V1 x,
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
   typedef typename V1::value_type T1;
-  typedef boost::gamma_distribution<T1> dist_type;
 
-  //#pragma omp parallel
-  //{
-    RngHost& rng1 = rng.getHostRng();
-    int j;
+  const boost::uint64_t s = rng.nextHostStream();
 
-    dist_type dist1(alpha), dist2(beta);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen1(rng1.rng, dist1), gen2(rng1.rng, dist2);
+  #pragma omp parallel
+  {
     T1 y1, y2;
+    int j;
 
-    //#pragma omp for schedule(static)
+    #pragma omp for schedule(static)
     for (j = 0; j < x.size(); ++j) {
-      y1 = gen1();
-      y2 = gen2();
+      RngHost rng1(rng.getHostStream(s, j));
+      y1 = rng1.gamma(alpha, static_cast<T1>(1.0));
+      y2 = rng1.gamma(beta, static_cast<T1>(1.0));
 
       x(j) = y1/(y1 + y2);
     }
-    //}
+  }
 }
 
 template<class V1, class V2>
@@ -171,21 +168,23 @@ void bi::RandomHost::multinomials(Random& rng, const V1 lps, V2 xs) {
 
   typedef typename V1::value_type T1;
 
-  RngHost& rng1 = rng.getHostRng();
   typename sim_temp_vector<V1>::type Ps(lps.size());
   sumexpu_inclusive_scan(lps, Ps);
 
-  T1 u;
-  T1 lower = 0.0;
-  T1 upper = *(Ps.end() - 1);
+  const boost::uint64_t s = rng.nextHostStream();
+  const T1 lower = 0.0;
+  const T1 upper = *(Ps.end() - 1);
 
-  int i, p;
-  for (i = 0; i < xs.size(); ++i) {
-    ///@todo Review implementation, in particular the next two repeated calls
-    u = rng1.uniform(lower, upper);
-    p = thrust::lower_bound(Ps.begin(), Ps.end(), u) - Ps.begin();
+  #pragma omp parallel
+  {
+    T1 u;
+    int i;
 
-    xs(i) = p;
+    #pragma omp for schedule(static)
+    for (i = 0; i < xs.size(); ++i) {
+      u = rng.getHostStream(s, i).uniform(lower, upper);
+      xs(i) = thrust::lower_bound(Ps.begin(), Ps.end(), u) - Ps.begin();
+    }
   }
 }
 
@@ -8,7 +8,7 @@
 #ifndef BI_HOST_RANDOM_RNG_HPP
 #define BI_HOST_RANDOM_RNG_HPP
 
-#include "boost/random/mersenne_twister.hpp"
+#include "PhiloxHost.hpp"
 
 namespace bi {
 /**
@@ -16,15 +16,10 @@ namespace bi {
  *
  * @ingroup math_rng
  *
- * Uses the Mersenne Twister algorithm for generating pseudorandom variates,
- * as implemented in Boost.Random.
- *
- * @section RngHost_references References
- *
- * @anchor Matsumoto1998 Matsumoto, M. and Nishimura,
- * T. Mersenne Twister: A 623-dimensionally equidistributed
- * uniform pseudorandom number generator. <i>ACM Transactions on
- * Modeling and Computer Simulation</i>, <b>1998</b>, 8, 3-30.
+ * Uses the counter-based PhiloxHost generator for generating pseudorandom
+ * variates, with distributions as implemented in Boost.Random. As the
+ * generator has no state other than its key and counter, copies are cheap,
+ * and independent streams can be forked with #stream.
  */
 class RngHost {
 public:
@@ -32,8 +27,14 @@ public:
    * Seed random number generator.
    *
    * @param seed Seed value.
+   * @param id Second key word, e.g. process number.
+   */
+  void seed(const unsigned seed, const unsigned id = 0);
+
+  /**
+   * @copydoc PhiloxHost::stream
    */
-  void seed(const unsigned seed);
+  void stream(const boost::uint64_t s, const boost::uint32_t ss = 0);
 
   /**
    * @copydoc Random::uniformInt
@@ -61,6 +62,11 @@ public:
 
   /**
    * @copydoc Random::gamma
+   *
+   * Uses the squeeze and rejection sampling method of @ref Marsaglia2000
+   * "Marsaglia & Tsang (2000)", as RngGPU::gamma does, rather than
+   * Boost.Random, as it is faster and shares its arithmetic with the
+   * vectorised RandomSSE::gammas.
    */
   template<class T1>
   T1 gamma(const T1 alpha = 1.0, const T1 beta = 1.0);
@@ -68,7 +74,7 @@ public:
   /**
    * Random number generator type.
    */
-  typedef boost::mt19937 rng_type;
+  typedef PhiloxHost rng_type;
 
   /**
    * Random number generator.
@@ -78,18 +84,23 @@ public:
 }
 
 #include "../../misc/omp.hpp"
+#include "../../math/function.hpp"
 #include "../../math/sim_temp_vector.hpp"
 
 #include "boost/random/uniform_int.hpp"
 #include "boost/random/uniform_real.hpp"
 #include "boost/random/normal_distribution.hpp"
-#include "boost/random/gamma_distribution.hpp"
 #include "boost/random/variate_generator.hpp"
 
 #include "thrust/binary_search.h"
 
-inline void bi::RngHost::seed(const unsigned seed) {
-  rng.seed(seed);
+inline void bi::RngHost::seed(const unsigned seed, const unsigned id) {
+  rng.seed(seed, id);
+}
+
+inline void bi::RngHost::stream(const boost::uint64_t s,
+    const boost::uint32_t ss) {
+  rng.stream(s, ss);
 }
 
 template<class T1>
@@ -152,12 +163,35 @@ inline T1 bi::RngHost::gamma(const T1 alpha, const T1 beta) {
   /* pre-condition */
   BI_ASSERT(alpha > 0.0 && beta > 0.0);
 
-  typedef boost::gamma_distribution<T1> dist_type;
-
-  dist_type dist(alpha);
-  boost::variate_generator<rng_type&, dist_type> gen(rng, dist);
-
-  return beta*gen();
+  const T1 zero = static_cast<T1>(0.0);
+  const T1 one = static_cast<T1>(1.0);
+
+  T1 d = alpha - static_cast<T1>(1.0/3.0);
+  T1 scale;
+  if (alpha < one) {
+    /* boost to alpha > 1 case */
+    scale = beta*bi::pow(this->uniform(zero, one), one/alpha);
+    d += one;
+  } else {
+    scale = beta;
+  }
+  T1 c = one/bi::sqrt(static_cast<T1>(9.0)*d);
+  T1 x, x2, v, dv, u;
+
+  do {
+    do {
+      x = this->gaussian(zero, one);
+      v = one + c*x;
+    } while (v <= zero);
+
+    x2 = x*x;
+    v = v*v*v;
+    dv = d*v;
+    u = this->uniform(zero, one);
+  } while (u >= one - static_cast<T1>(0.0331)*x2*x2 &&
+      bi::log(u) >= static_cast<T1>(0.5)*x2 + d - dv + d*bi::log(v));
+
+  return scale*dv;
 }
 
 #endif
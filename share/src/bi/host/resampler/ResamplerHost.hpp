@@ -8,7 +8,9 @@
 #ifndef BI_HOST_RESAMPLER_RESAMPLERHOST_HPP
 #define BI_HOST_RESAMPLER_RESAMPLERHOST_HPP
 
+#include "../math/temp_vector.hpp"
 #include "../../primitive/vector_primitive.hpp"
+#include "../../misc/omp.hpp"
 
 template<class V1, class V2>
 void bi::ResamplerHost::ancestorsToOffspring(const V1 as, V2 os) {
@@ -32,11 +34,46 @@ void bi::ResamplerHost::offspringToAncestors(const V1 os, V2 as) {
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o;
-  for (i = 0; i < os.size(); ++i) {
-    o = os(i);
-    for (j = 0; j < o; ++j) {
-      as(k++) = i;
+  const int N = os.size();
+  const int T = bi_omp_max_threads;
+  typename temp_host_vector<int>::type Ks(T);
+
+  #pragma omp parallel
+  {
+    int i, j, k, o, t, start, end;
+
+    /* offspring of each block */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(N, t, T, start, end);
+      k = 0;
+      for (i = start; i < end; ++i) {
+        k += os(i);
+      }
+      Ks(t) = k;
+    }
+
+    /* exclusive prefix sum across blocks */
+    #pragma omp single
+    {
+      int K = 0;
+      for (t = 0; t < T; ++t) {
+        k = Ks(t);
+        Ks(t) = K;
+        K += k;
+      }
+    }
+
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(N, t, T, start, end);
+      k = Ks(t);
+      for (i = start; i < end; ++i) {
+        o = os(i);
+        for (j = 0; j < o; ++j) {
+          as(k++) = i;
+        }
+      }
     }
   }
 }
@@ -45,23 +82,12 @@ template<class V1, class V2>
 void bi::ResamplerHost::offspringToAncestorsPermute(const V1 os, V2 as) {
   /* pre-conditions */
   BI_ASSERT(sum_reduce(os) == as.size());
+  BI_ASSERT(os.size() == as.size());
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o;
-  for (i = 0; i < os.size(); ++i) {
-    o = os(i);
-    if (o > 0) {
-      as(i) = i;
-      --o;
-    }
-    for (j = 0; j < o; ++j) {
-      while (os(k) > 0) {
-        ++k;
-      }
-      as(k++) = i;
-    }
-  }
+  typename temp_host_vector<int>::type rest(0);
+  offspringToAncestorsPermute<false>(os, as, rest);
 }
 
 template<class V1, class V2>
@@ -93,56 +119,260 @@ void bi::ResamplerHost::cumulativeOffspringToAncestorsPermute(const V1 Os,
     V2 as) {
   /* pre-conditions */
   BI_ASSERT(*(Os.end() - 1) == as.size());
+  BI_ASSERT(Os.size() == as.size());
   BI_ASSERT(!V1::on_device);
   BI_ASSERT(!V2::on_device);
 
-  int i, j, k = 0, o, O1, O2;
-  for (i = 0; i < Os.size(); ++i) {
-    O1 = (i > 0) ? Os(i - 1) : 0;
-    O2 = Os(i);
-    o = O2 - O1;
+  typename temp_host_vector<int>::type rest(0);
+  offspringToAncestorsPermute<true>(Os, as, rest);
+}
 
-    if (o > 0) {
-      as(i) = i;
-      --o;
+template<class V1>
+void bi::ResamplerHost::permute(V1 as) {
+  /* pre-condition */
+  BI_ASSERT(!V1::on_device);
+
+  const int P = as.size();
+  const int T = bi_omp_max_threads;
+  typename temp_host_vector<int>::type os(P), Ks(T), rest;
+  int K = 0;
+
+  os.clear();
+
+  #pragma omp parallel
+  {
+    int p, k, t, start, end;
+
+    /* offspring of each particle, and ancestors outside the range of
+     * particles, which cannot be placed with themselves */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      k = 0;
+      for (p = start; p < end; ++p) {
+        if (as(p) < P) {
+          #pragma omp atomic
+          ++os(as(p));
+        } else {
+          ++k;
+        }
+      }
+      Ks(t) = k;
     }
 
-    if (k == 0 && o > 0) { // deal with special case here rather than in loop
-      if (Os(k) > 0) {
-        ++k;
-      } else {
-        as(k++) = i;
-        --o;
+    #pragma omp single
+    {
+      for (t = 0; t < T; ++t) {
+        k = Ks(t);
+        Ks(t) = K;
+        K += k;
       }
+      rest.resize(K);
     }
 
-    for (j = 0; j < o; ++j) {
-      while (Os(k) - Os(k - 1) > 0) {
-        ++k;
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      k = Ks(t);
+      for (p = start; p < end; ++p) {
+        if (as(p) >= P) {
+          rest(k++) = as(p);
+        }
       }
-      as(k++) = i;
     }
   }
+
+  offspringToAncestorsPermute<false>(os, as, rest);
 }
 
-template<class V1>
-void bi::ResamplerHost::permute(V1 as) {
-  /* pre-condition */
+template<class V1, class M1>
+void bi::ResamplerHost::copy(const V1 as, M1 X) {
+  /* pre-conditions */
+  BI_ASSERT(as.size() <= X.size1());
   BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!M1::on_device);
+
+  if (bi_omp_team) {
+    copyTeam(as, X);
+    return;
+  }
 
   const int P = as.size();
+  const int N = X.size2();
+  const int T = bi_omp_max_threads;
+  typename temp_host_vector<int>::type Ks(T), is(P);
+  int K = 0;
+
+  #pragma omp parallel
+  {
+    int i, j, k, t, start, end, n, B;
+
+    /* list rows to be overwritten */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      k = 0;
+      for (i = start; i < end; ++i) {
+        k += (as(i) != i) ? 1 : 0;
+      }
+      Ks(t) = k;
+    }
+
+    #pragma omp single
+    {
+      for (t = 0; t < T; ++t) {
+        k = Ks(t);
+        Ks(t) = K;
+        K += k;
+      }
+    }
+
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      k = Ks(t);
+      for (i = start; i < end; ++i) {
+        if (as(i) != i) {
+          is(k++) = i;
+        }
+      }
+    }
+
+    /* copy, as tasks of one column and a range of the list each, with
+     * enough ranges per column to occupy all threads when there are few
+     * columns; sources are never overwritten, as they are their own
+     * ancestors after permute() */
+    B = (N > 0) ? (T + N - 1)/N : 0;
+    #pragma omp for schedule(static)
+    for (n = 0; n < N*B; ++n) {
+      j = n/B;
+      block(K, n % B, B, start, end);
+      for (k = start; k < end; ++k) {
+        i = is(k);
+        X(i, j) = X(as(i), j);
+      }
+    }
+  }
+}
+
+template<class V1, class M1>
+void bi::ResamplerHost::copyTeam(const V1 as, M1 X) {
+  /* pre-conditions */
+  BI_ASSERT(as.size() <= X.size1());
+  BI_ASSERT(!V1::on_device);
+  BI_ASSERT(!M1::on_device);
+
+  const int P = as.size();
+  const int N = X.size2();
+  const int T = bi_omp_max_threads;
+  const int B = (N > 0) ? (T + N - 1)/N : 0;
+  int i, j, n, start, end;
+
+  /* as in copy(), sources are never overwritten */
+  #pragma omp for schedule(static)
+  for (n = 0; n < N*B; ++n) {
+    j = n/B;
+    block(P, n % B, B, start, end);
+    for (i = start; i < end; ++i) {
+      if (as(i) != i) {
+        X(i, j) = X(as(i), j);
+      }
+    }
+  }
+}
+
+template<bool Cumulative, class V1>
+inline int bi::ResamplerHost::offspring(const V1 os, const int i) {
+  if (Cumulative) {
+    return (i > 0) ? os(i) - os(i - 1) : os(i);
+  } else {
+    return os(i);
+  }
+}
+
+inline void bi::ResamplerHost::block(const int P, const int t, const int T,
+    int& start, int& end) {
+  start = static_cast<int>((static_cast<long>(P)*t)/T);
+  end = static_cast<int>((static_cast<long>(P)*(t + 1))/T);
+}
+
+template<bool Cumulative, class V1, class V2, class V3>
+void bi::ResamplerHost::offspringToAncestorsPermute(const V1 os, V2 as,
+    const V3 rest) {
+  const int P = as.size();
+  const int T = bi_omp_max_threads;
+  typename temp_host_vector<int>::type Es(T), Fs(T), fs(P);
+  int E = 0;
+
+  #pragma omp parallel
+  {
+    int i, j, e, f, o, t, start, end;
+
+    /* surplus offspring and free places of each block */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      e = 0;
+      f = 0;
+      for (i = start; i < end; ++i) {
+        o = offspring<Cumulative>(os, i);
+        if (o > 0) {
+          e += o - 1;
+        } else {
+          ++f;
+        }
+      }
+      Es(t) = e;
+      Fs(t) = f;
+    }
+
+    /* exclusive prefix sums across blocks */
+    #pragma omp single
+    {
+      int F = 0;
+      for (t = 0; t < T; ++t) {
+        e = Es(t);
+        f = Fs(t);
+        Es(t) = E;
+        Fs(t) = F;
+        E += e;
+        F += f;
+      }
+      BI_ASSERT(F == E + rest.size());
+    }
+
+    /* list free places */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      f = Fs(t);
+      for (i = start; i < end; ++i) {
+        if (offspring<Cumulative>(os, i) == 0) {
+          fs(f++) = i;
+        }
+      }
+    }
+
+    /* fill own places, then free places, the latter belonging to other
+     * blocks only where nothing else is written */
+    #pragma omp for schedule(static)
+    for (t = 0; t < T; ++t) {
+      block(P, t, T, start, end);
+      e = Es(t);
+      for (i = start; i < end; ++i) {
+        o = offspring<Cumulative>(os, i);
+        if (o > 0) {
+          as(i) = i;
+          for (j = 1; j < o; ++j) {
+            as(fs(e++)) = i;
+          }
+        }
+      }
+    }
 
-  typename V1::size_type i;
-  typename V1::value_type j, k;
-
-  for (i = 0; i < as.size(); ++i) {
-    k = as(i);
-    if (k < P && k != i && as(k) != k) {
-      /* swap */
-      j = as(k);
-      as(k) = k;
-      as(i) = j;
-      --i; // repeat for new value
+    #pragma omp for schedule(static)
+    for (i = 0; i < rest.size(); ++i) {
+      as(fs(E + i)) = rest(i);
     }
   }
 }
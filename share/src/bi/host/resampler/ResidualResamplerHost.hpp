@@ -0,0 +1,158 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_HOST_RESAMPLER_RESIDUALRESAMPLERHOST_HPP
+#define BI_HOST_RESAMPLER_RESIDUALRESAMPLERHOST_HPP
+
+#include "../math/temp_vector.hpp"
+#include "../../primitive/vector_primitive.hpp"
+#include "../../math/misc.hpp"
+#include "../../misc/omp.hpp"
+#ifdef ENABLE_SSE
+#include "../../sse/math/scalar.hpp"
+#endif
+
+#include "boost/type_traits/is_same.hpp"
+
+#include <algorithm>
+#include <vector>
+
+template<class V1, class V2>
+void bi::ResidualResamplerHost::offspring(Random& rng, const V1 lws, V2 os,
+    const int n, const bool systematic)
+    throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == os.size());
+
+  typedef typename V1::value_type T1;
+  typename temp_host_vector<T1>::type rs(lws.size());
+  int R;
+
+  #ifdef ENABLE_SSE
+  /* log-weights may be a range of a larger vector, so not aligned */
+  if (boost::is_same<T1,real>::value && lws.inc() == 1 &&
+      lws.size() % BI_SIMD_SIZE == 0 && simd_aligned(lws.buf()) &&
+      simd_aligned(rs.buf())) {
+    R = ResidualResamplerSSE::deterministic(lws, os, rs, n);
+  } else {
+    R = deterministic(lws, os, rs, n);
+  }
+  #else
+  R = deterministic(lws, os, rs, n);
+  #endif
+  if (R > 0) {
+    residual(rng, rs, os, R, systematic);
+  }
+}
+
+template<class V1, class V2, class V3>
+int bi::ResidualResamplerHost::deterministic(const V1 lws, V2 os, V3 rs,
+    const int n) throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == os.size());
+  BI_ASSERT(lws.size() == rs.size());
+
+  typedef typename V1::value_type T1;
+
+  const int P = lws.size();
+  const T1 mx = max_reduce(lws);
+  std::vector<T1> Ws(bi_omp_max_threads, 0.0);
+  T1 W = 0.0;
+  int i, t, m = 0;
+
+  if (!is_finite(mx)) {
+    throw ParticleFilterDegeneratedException();
+  }
+
+  #pragma omp parallel
+  {
+    T1 W1 = 0.0;
+
+    #pragma omp for
+    for (i = 0; i < P; ++i) {
+      rs(i) = bi::exp(lws(i) - mx);
+      W1 += rs(i);
+    }
+    Ws[bi_omp_tid] = W1;
+  }
+
+  /* combine in thread order, so that the result is reproducible */
+  for (t = 0; t < bi_omp_max_threads; ++t) {
+    W += Ws[t];
+  }
+
+  const T1 c = n/W;
+
+  #pragma omp parallel for reduction(+:m)
+  for (i = 0; i < P; ++i) {
+    T1 x = c*rs(i);
+    os(i) = static_cast<int>(x);
+    rs(i) = x - os(i);
+    m += os(i);
+  }
+
+  if (m > n) {
+    overshoot(os, m - n);
+    m = n;
+  }
+  return n - m;
+}
+
+template<class V1, class V2>
+void bi::ResidualResamplerHost::residual(Random& rng, const V1 rs, V2 os,
+    const int R, const bool systematic) {
+  /* pre-condition */
+  BI_ASSERT(rs.size() == os.size());
+
+  typedef typename V1::value_type T1;
+
+  const int P = rs.size();
+  typename temp_host_vector<T1>::type Rs(P);
+  int i;
+
+  sum_inclusive_scan(rs, Rs);
+  const T1 W = *(Rs.end() - 1);
+
+  if (systematic) {
+    /* one uniform, then each particle's offspring from its own bounds */
+    const T1 u = rng.uniform<T1>();
+    const T1 c = R/W;
+
+    #pragma omp parallel for
+    for (i = 0; i < P; ++i) {
+      int O1 = (i > 0) ? bi::min(R, static_cast<int>(c*Rs(i - 1) + u)) : 0;
+      int O2 = bi::min(R, static_cast<int>(c*Rs(i) + u));
+      os(i) += O2 - O1;
+    }
+  } else {
+    /* one uniform and one search per residual offspring */
+    typename temp_host_vector<T1>::type alphas(R);
+    typename temp_host_vector<int>::type js(R);
+
+    rng.uniforms(alphas, 0.0, W);
+    bi::upper_bound(Rs, alphas, js);
+
+    #pragma omp parallel for
+    for (i = 0; i < R; ++i) {
+      #pragma omp atomic
+      ++os(bi::min(js(i), P - 1));
+    }
+  }
+}
+
+template<class V1>
+void bi::ResidualResamplerHost::overshoot(V1 os, const int e) {
+  typename V1::iterator iter;
+  int k;
+
+  for (k = 0; k < e; ++k) {
+    iter = std::max_element(os.begin(), os.end());
+    --*iter;
+  }
+}
+
+#endif
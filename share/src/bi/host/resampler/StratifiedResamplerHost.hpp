@@ -34,16 +34,17 @@ void bi::StratifiedResamplerHost::op(Random& rng, const V1 Ws, V2 Os,
   typedef typename V1::value_type T1;
   typedef boost::uniform_real<T1> dist_type;
 
+  const boost::uint64_t s = rng.nextHostStream();
+
   #pragma omp parallel
   {
-    RngHost& rng1 = rng.getHostRng();
-    int i;
-
     dist_type dist(0.0, 1.0);
-    boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
+    int i;
 
     #pragma omp for
     for (i = 0; i < alphas.size(); ++i) {
+      RngHost rng1(rng.getHostStream(s, i));
+      boost::variate_generator<RngHost::rng_type&, dist_type> gen(rng1.rng, dist);
       alphas(i) = gen();
     }
 
@@ -36,12 +36,21 @@ public:
   template<class T1>
   static void samples(Random& rng, const T1 t1, const T1 t2,
       State<B,ON_HOST>& s, const int p);
+
+private:
+  /**
+   * Sample, sharing trajectories among the threads of the current team.
+   */
+  template<class T1>
+  static void samplesTeam(Random& rng, const T1 t1, const T1 t2,
+      State<B,ON_HOST>& s);
 };
 }
 
 #include "DynamicSamplerVisitorHost.hpp"
 #include "DynamicSamplerMatrixVisitorHost.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../state/Ou.hpp"
 #include "../../traits/block_traits.hpp"
@@ -50,6 +59,20 @@ template<class B, class S>
 template<class T1>
 void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
     const T1 t2, State<B,ON_HOST>& s) {
+  if (bi_omp_team) {
+    samplesTeam(rng, t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      samplesTeam(rng, t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S>
+template<class T1>
+void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s, const int p) {
   typedef RngHost R1;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
@@ -58,24 +81,15 @@ void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
-  #pragma omp parallel
-  {
-    PX pax;
-    OX x;
-    R1& rng1 = rng.getHostRng();
-    int p;
-
-    #pragma omp for
-    for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(rng1, t1, t2, s, p, pax, x);
-    }
-  }
+  PX pax;
+  OX x;
+  Visitor::accept(rng.getHostRng(), t1, t2, s, p, pax, x);
 }
 
 template<class B, class S>
 template<class T1>
-void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
-    const T1 t2, State<B,ON_HOST>& s, const int p) {
+void bi::DynamicSamplerHost<B,S>::samplesTeam(Random& rng, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
   typedef RngHost R1;
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
@@ -86,7 +100,20 @@ void bi::DynamicSamplerHost<B,S>::samples(Random& rng, const T1 t1,
 
   PX pax;
   OX x;
-  Visitor::accept(rng.getHostRng(), t1, t2, s, p, pax, x);
+  boost::uint64_t st;
+  int p;
+
+  /* one stream for the whole team */
+  #pragma omp single copyprivate(st)
+  st = rng.nextHostStream();
+
+  #pragma omp for
+  for (p = 0; p < s.size(); ++p) {
+    /* own stream per particle, for results independent of thread count and
+     * tiling */
+    R1 rng1(rng.getHostStream(st, s.start() + p));
+    Visitor::accept(rng1, t1, t2, s, p, pax, x);
+  }
 }
 
 #endif
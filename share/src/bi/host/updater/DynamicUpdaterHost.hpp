@@ -28,12 +28,20 @@ public:
   template<class T1>
   static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
       const int p);
+
+private:
+  /**
+   * Update, sharing trajectories among the threads of the current team.
+   */
+  template<class T1>
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
 #include "DynamicUpdaterVisitorHost.hpp"
 #include "DynamicUpdaterMatrixVisitorHost.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../state/Ou.hpp"
 #include "../../traits/block_traits.hpp"
@@ -47,22 +55,12 @@ void bi::DynamicUpdaterHost<B,S>::update(const T1 t1, const T1 t2,
   /* pre-conditions */
   BI_ASSERT(t1 <= t2);
 
-  typedef Pa<ON_HOST,B,host,host,host,host> PX;
-  typedef Ou<ON_HOST,B,host> OX;
-  typedef DynamicUpdaterMatrixVisitorHost<B,S,T1,PX,OX> MatrixVisitor;
-  typedef DynamicUpdaterVisitorHost<B,S,T1,PX,OX> ElementVisitor;
-  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
-      ElementVisitor>::type Visitor;
-
-#pragma omp parallel
-  {
-    PX pax;
-    OX x;
-    int p;
-
-    #pragma omp for
-    for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(t1, t2, s, p, pax, x);
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
     }
   }
 }
@@ -86,4 +84,25 @@ void bi::DynamicUpdaterHost<B,S>::update(const T1 t1, const T1 t2,
   Visitor::accept(t1, t2, s, p, pax, x);
 }
 
+template<class B, class S>
+template<class T1>
+void bi::DynamicUpdaterHost<B,S>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef Ou<ON_HOST,B,host> OX;
+  typedef DynamicUpdaterMatrixVisitorHost<B,S,T1,PX,OX> MatrixVisitor;
+  typedef DynamicUpdaterVisitorHost<B,S,T1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  PX pax;
+  OX x;
+  int p;
+
+  #pragma omp for
+  for (p = 0; p < s.size(); ++p) {
+    Visitor::accept(t1, t2, s, p, pax, x);
+  }
+}
+
 #endif
@@ -9,6 +9,7 @@
 #define BI_HOST_UPDATER_SPARSESTATICLOGDENSITYHOST_HPP
 
 #include "../../state/State.hpp"
+#include "../../primitive/vector_primitive.hpp"
 
 namespace bi {
 /**
@@ -35,12 +36,41 @@ public:
   template<class V1>
   static void logDensities(State<B,ON_HOST>& s, const int p,
       const Mask<ON_HOST>& mask, V1 lp);
+
+  /**
+   * @copydoc SparseStaticLogDensity::logDensities(State<B,ON_HOST>&, const Mask<ON_HOST>&, V1, typename V1::value_type&, typename V1::value_type&, typename V1::value_type&)
+   */
+  template<class V1>
+  static void logDensities(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask,
+      V1 lp, typename V1::value_type& mx, typename V1::value_type& sum1,
+      typename V1::value_type& sum2);
+
+private:
+  /**
+   * Evaluate log-density, sharing trajectories among the threads of the
+   * current team.
+   */
+  template<class V1>
+  static void logDensitiesTeam(State<B,ON_HOST>& s,
+      const Mask<ON_HOST>& mask, V1 lp);
+
+  /**
+   * Evaluate log-density and reduce the result, sharing trajectories among
+   * the threads of the current team.
+   *
+   * @param[out] acc Accumulator of the calling thread's trajectories.
+   */
+  template<class V1>
+  static void logDensitiesTeam(State<B,ON_HOST>& s,
+      const Mask<ON_HOST>& mask, V1 lp,
+      max_sumexp_accumulator<typename V1::value_type>& acc);
 };
 }
 
 #include "SparseStaticLogDensityVisitorHost.hpp"
 #include "SparseStaticLogDensityMatrixVisitorHost.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../state/Ou.hpp"
 #include "../../traits/block_traits.hpp"
@@ -49,6 +79,20 @@ template<class B, class S>
 template<class V1>
 void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
     const Mask<ON_HOST>& mask, V1 lp) {
+  if (bi_omp_team) {
+    logDensitiesTeam(s, mask, lp);
+  } else {
+    #pragma omp parallel
+    {
+      logDensitiesTeam(s, mask, lp);
+    }
+  }
+}
+
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
+    const int p, const Mask<ON_HOST>& mask, V1 lp) {
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
   typedef SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
@@ -56,23 +100,54 @@ void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
-  #pragma omp parallel
-  {
-    PX pax;
-    OX x;
-    int p;
+  PX pax;
+  OX x;
+  Visitor::accept(mask, s, p, pax, x, lp(p));
+}
 
-    #pragma omp for
-    for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(mask, s, p, pax, x, lp(p));
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
+    const Mask<ON_HOST>& mask, V1 lp, typename V1::value_type& mx,
+    typename V1::value_type& sum1, typename V1::value_type& sum2) {
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef Ou<ON_HOST,B,host> OX;
+  typedef SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef SparseStaticLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+  typedef typename V1::value_type T1;
+
+  if (bi_omp_team) {
+    max_sumexp_accumulator<T1> acc1;
+    logDensitiesTeam(s, mask, lp, acc1);
+    max_sumexp_combine_team(acc1, mx, sum1, sum2);
+  } else {
+    std::vector<max_sumexp_accumulator<T1> > accs(bi_omp_max_threads);
+    max_sumexp_accumulator<T1> acc;
+    int t;
+
+    #pragma omp parallel
+    {
+      max_sumexp_accumulator<T1> acc1;
+      logDensitiesTeam(s, mask, lp, acc1);
+      accs[bi_omp_tid] = acc1;
     }
+
+    /* combine in thread order, so that the result is reproducible */
+    for (t = 0; t < bi_omp_max_threads; ++t) {
+      acc.combine(accs[t]);
+    }
+    mx = acc.mx;
+    sum1 = acc.sum1;
+    sum2 = acc.sum2;
   }
 }
 
 template<class B, class S>
 template<class V1>
-void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
-    const int p, const Mask<ON_HOST>& mask, V1 lp) {
+void bi::SparseStaticLogDensityHost<B,S>::logDensitiesTeam(
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, V1 lp) {
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
   typedef SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
@@ -82,7 +157,35 @@ void bi::SparseStaticLogDensityHost<B,S>::logDensities(State<B,ON_HOST>& s,
 
   PX pax;
   OX x;
-  Visitor::accept(mask, s, p, pax, x, lp(p));
+  int p;
+
+  #pragma omp for
+  for (p = 0; p < s.size(); ++p) {
+    Visitor::accept(mask, s, p, pax, x, lp(p));
+  }
+}
+
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticLogDensityHost<B,S>::logDensitiesTeam(
+    State<B,ON_HOST>& s, const Mask<ON_HOST>& mask, V1 lp,
+    max_sumexp_accumulator<typename V1::value_type>& acc) {
+  typedef Pa<ON_HOST,B,host,host,host,host> PX;
+  typedef Ou<ON_HOST,B,host> OX;
+  typedef SparseStaticLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef SparseStaticLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  PX pax;
+  OX x;
+  int p;
+
+  #pragma omp for
+  for (p = 0; p < s.size(); ++p) {
+    Visitor::accept(mask, s, p, pax, x, lp(p));
+    acc.add(lp(p));
+  }
 }
 
 #endif
@@ -27,12 +27,19 @@ public:
 
   static void update(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask,
       const int p);
+
+private:
+  /**
+   * Update, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask);
 };
 }
 
 #include "SparseStaticUpdaterVisitorHost.hpp"
 #include "SparseStaticUpdaterMatrixVisitorHost.hpp"
 #include "../host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../state/Pa.hpp"
 #include "../../state/Ou.hpp"
 #include "../../traits/block_traits.hpp"
@@ -40,6 +47,19 @@ public:
 template<class B, class S>
 void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
     const Mask<ON_HOST>& mask) {
+  if (bi_omp_team) {
+    updateTeam(s, mask);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(s, mask);
+    }
+  }
+}
+
+template<class B, class S>
+void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
+    const Mask<ON_HOST>& mask, const int p) {
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
   typedef SparseStaticUpdaterMatrixVisitorHost<B,S,ON_HOST,PX,OX> MatrixVisitor;
@@ -47,22 +67,14 @@ void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
-#pragma omp parallel
-  {
-    PX pax;
-    OX x;
-    int p;
-
-#pragma omp for
-    for (p = 0; p < s.size(); ++p) {
-      Visitor::accept(s, mask, p, pax, x);
-    }
-  }
+  PX pax;
+  OX x;
+  Visitor::accept(s, mask, p, pax, x);
 }
 
 template<class B, class S>
-void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
-    const Mask<ON_HOST>& mask, const int p) {
+void bi::SparseStaticUpdaterHost<B,S>::updateTeam(State<B,ON_HOST>& s,
+    const Mask<ON_HOST>& mask) {
   typedef Pa<ON_HOST,B,host,host,host,host> PX;
   typedef Ou<ON_HOST,B,host> OX;
   typedef SparseStaticUpdaterMatrixVisitorHost<B,S,ON_HOST,PX,OX> MatrixVisitor;
@@ -72,7 +84,12 @@ void bi::SparseStaticUpdaterHost<B,S>::update(State<B,ON_HOST>& s,
 
   PX pax;
   OX x;
-  Visitor::accept(s, mask, p, pax, x);
+  int p;
+
+  #pragma omp for
+  for (p = 0; p < s.size(); ++p) {
+    Visitor::accept(s, mask, p, pax, x);
+  }
 }
 
 #endif
@@ -52,15 +52,19 @@ void bi::StaticSamplerHost<B,S>::samples(Random& rng, State<B,ON_HOST>& s) {
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
+  const boost::uint64_t st = rng.nextHostStream();
+
 #pragma omp parallel
   {
     PX pax;
     OX x;
-    R1& rng1 = rng.getHostRng();
     int p;
 
 #pragma omp for
     for (p = 0; p < s.size(); ++p) {
+      /* own stream per particle, for results independent of thread count and
+       * tiling */
+      R1 rng1(rng.getHostStream(st, s.start() + p));
       Visitor::accept(rng1, s, p, pax, x);
     }
   }
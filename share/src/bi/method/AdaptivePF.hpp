@@ -145,10 +145,11 @@ double bi::AdaptivePF<B,S,R,S2>::step(Random& rng, ScheduleIterator& iter,
 
   /* state at current time */
   matrix_type X(P, N);
-  vector_type lws(P);
+  vector_type hs(P), lws(P);
   int_vector_type as(P);
 
   X = s.getDyn();
+  hs = s.getStep();
   lws = s.logWeights();
   as = s.ancestors();
 
@@ -178,10 +179,12 @@ double bi::AdaptivePF<B,S,R,S2>::step(Random& rng, ScheduleIterator& iter,
         if (iter1->hasOutput()) {
           this->resam.ancestors(rng, lws, s.ancestors()/*, pre*/);
           this->resam.copy(s.ancestors(), X, s.getDyn());
+          bi::gather(s.ancestors(), hs, s.getStep());
         } else {
           typename S1::temp_int_vector_type as1(blockP);
           this->resam.ancestors(rng, lws, as1/*, pre*/);
           this->resam.copy(as1, X, s.getDyn());
+          bi::gather(as1, hs, s.getStep());
           bi::gather(as1, as, s.ancestors());
         }
         s.logWeights().clear();
@@ -13,6 +13,10 @@
 #include "../state/BootstrapPFState.hpp"
 #include "../cache/BootstrapPFCache.hpp"
 
+#include "boost/mpl/bool.hpp"
+
+#include <vector>
+
 namespace bi {
 /**
  * Bootstrap particle filter.
@@ -144,6 +148,45 @@ public:
   template<class S1>
   double correct(Random& rng, const ScheduleElement now, S1& s);
 
+  /**
+   * Upper bound on the incremental log-likelihood estimate that correct()
+   * will return at a given time.
+   *
+   * @tparam S1 State type.
+   *
+   * @param now Step in time schedule.
+   * @param s State, containing the inputs and observations at @p now.
+   *
+   * @return Upper bound on the incremental log-likelihood.
+   *
+   * Weights are normalised to a mean of one before each correction, so that
+   * the estimate cannot exceed the maximum log-density of the observations.
+   * This is a bound provided that the maximum does not depend on the state
+   * variables, as for RejectionResampler.
+   */
+  template<class S1>
+  double getMaxLogLikelihood(const ScheduleElement now, S1& s);
+
+  /**
+   * Upper bounds on the sum of the incremental log-likelihood estimates
+   * still to come after each step in a time schedule.
+   *
+   * @tparam S1 State type.
+   *
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s State, at @p first.
+   * @param[out] maxlls Upper bounds. Element @c i bounds the sum of the
+   * increments of the steps after <tt>first + i</tt>.
+   *
+   * The inputs and observations of each step are loaded into a scratch copy
+   * of the first trajectory of @p s, in turn, so that the bound of each step
+   * is computed with those of its own time. @p s is unchanged.
+   */
+  template<class S1>
+  void getMaxLogLikelihoods(const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, std::vector<double>& maxlls);
+
   /**
    * Resample.
    *
@@ -213,6 +256,57 @@ protected:
   template<class S1>
   double getMaxLogWeight(const ScheduleElement now, S1& s);
 
+  /**
+   * Resample, predict and correct within one persistent team of threads.
+   *
+   * @see step()
+   *
+   * The team is forked once for the whole step. Updaters of the
+   * transition and observation models, the reduction of weights and, for
+   * resamplers with resampler_can_split, the copy of particles share their
+   * work among the team. The selection of ancestors, other resamplers and
+   * output run on the master thread only, the rest of the team waiting at
+   * a barrier.
+   */
+  template<class S1, class IO1>
+  double stepTeam(Random& rng, ScheduleIterator& iter,
+      const ScheduleIterator last, S1& s, IO1& out);
+
+  /**
+   * Resample within a persistent team, on the master thread, up to the
+   * copy of particles.
+   *
+   * @tparam S1 State type.
+   * @tparam V1 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param now Current step in time schedule.
+   * @param[in,out] s State.
+   * @param lW Log of the sum of weights, as from Resampler::reduce().
+   * @param ess Effective sample size, as from Resampler::reduce().
+   * @param[out] as Ancestors, permuted.
+   *
+   * @return True if particles are still to be copied with @p as, false
+   * otherwise.
+   */
+  template<class S1, class V1>
+  bool resampleAncestors(Random& rng, const ScheduleElement now, S1& s,
+      const double lW, const double ess, V1 as);
+
+  /**
+   * Select and permute ancestors with a resampler that can split.
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as,
+      boost::mpl::true_);
+
+  /**
+   * Resamplers that cannot split are not used this way.
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as,
+      boost::mpl::false_);
+
   /**
    * Model.
    */
@@ -233,6 +327,8 @@ protected:
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
 #include "../traits/resampler_traits.hpp"
+#include "../misc/omp.hpp"
+#include "../misc/exception.hpp"
 
 template<class B, class S, class R>
 bi::BootstrapPF<B,S,R>::BootstrapPF(B& m, S& sim, R& resam) :
@@ -273,6 +369,10 @@ template<class B, class S, class R>
 template<class S1, class IO1>
 double bi::BootstrapPF<B,S,R>::step(Random& rng, ScheduleIterator& iter,
     const ScheduleIterator last, S1& s, IO1& out) {
+  if (bi_omp_persistent && !S1::on_device) {
+    return stepTeam(rng, iter, last, s, out);
+  }
+
   double ll = 0.0;
   do {
     resample(rng, *iter, s);
@@ -285,6 +385,159 @@ double bi::BootstrapPF<B,S,R>::step(Random& rng, ScheduleIterator& iter,
   return ll;
 }
 
+template<class B, class S, class R>
+template<class S1, class IO1>
+double bi::BootstrapPF<B,S,R>::stepTeam(Random& rng, ScheduleIterator& iter,
+    const ScheduleIterator last, S1& s, IO1& out) {
+  typename S1::temp_int_vector_type as(s.size());
+  double ll = 0.0;
+  bool more = true, split = false, degenerated = false, failed = false;
+  int info = 0;
+
+  /* exceptions cannot leave the parallel region, so those thrown within
+   * it are recorded and rethrown after it */
+  bi_omp_team_state team;
+
+  #pragma omp parallel
+  {
+    double lW = 0.0, ess = 0.0, ll1;
+
+    bi_omp_team_begin(team);
+    do {
+      /* weights reduced by the team, ancestors selected by the master,
+       * particles copied by the team */
+      if (iter->isObserved()) {
+        resam.reduce(s.logWeights(), lW, ess);
+      }
+      if (bi_omp_serial_begin()) {
+        try {
+          split = resampleAncestors(rng, *iter, s, lW, ess, as);
+          ++iter;
+        } catch (CholeskyException e) {
+          info = e.info;
+          failed = true;
+        } catch (ParticleFilterDegeneratedException e) {
+          degenerated = true;
+          failed = true;
+        }
+      }
+      bi_omp_serial_end();
+      if (failed) {
+        break;
+      }
+      if (split) {
+        Resampler::copy(as, s.getDyn());
+      }
+
+      /* updaters rethrow on the whole team, with the error code of the
+       * master, see bi_omp_serial_end() */
+      try {
+        predict(rng, *iter, s);
+      } catch (CholeskyException e) {
+        #pragma omp critical(bi_pf_team_failed)
+        {
+          info = e.info;
+          failed = true;
+        }
+      } catch (ParticleFilterDegeneratedException e) {
+        #pragma omp critical(bi_pf_team_failed)
+        {
+          degenerated = true;
+          failed = true;
+        }
+      }
+      #pragma omp barrier
+      if (failed) {
+        break;
+      }
+
+      /* weights updated and reduced by the team, output by the master */
+      ll1 = correct(rng, *iter, s);
+      if (bi_omp_serial_begin()) {
+        try {
+          ll += ll1;
+          output(*iter, s, out);
+          more = iter + 1 != last && !iter->isObserved();
+        } catch (CholeskyException e) {
+          info = e.info;
+          failed = true;
+          more = false;
+        } catch (ParticleFilterDegeneratedException e) {
+          degenerated = true;
+          failed = true;
+          more = false;
+        }
+      }
+      bi_omp_serial_end();
+    } while (more);
+    bi_omp_team_end();
+  }
+
+  if (degenerated) {
+    throw ParticleFilterDegeneratedException();
+  } else if (failed) {
+    throw CholeskyException(info);
+  }
+  return ll;
+}
+
+template<class B, class S, class R>
+template<class S1, class V1>
+bool bi::BootstrapPF<B,S,R>::resampleAncestors(Random& rng,
+    const ScheduleElement now, S1& s, const double lW, const double ess,
+    V1 as) {
+  bool r = now.isObserved(), split = false;
+  if (r) {
+    r = resam.isTriggered(ess, s.size());
+    if (r) {
+      if (resampler_needs_max<R>::value) {
+        resam.setMaxLogWeight(getMaxLogWeight(now, s));
+      }
+      if (resampler_can_split<R>::value) {
+        /* as resample(), but for the copy of particles */
+        ancestorsPermute(rng, s.logWeights(), as,
+            boost::mpl::bool_<resampler_can_split<R>::value>());
+        s.logWeights().clear();
+        bi::gather(as, s.getStep(), s.getStep());
+        if (now.hasOutput()) {
+          s.ancestors() = as;
+        } else {
+          bi::gather(as, s.ancestors(), s.ancestors());
+        }
+        split = true;
+      } else if (now.hasOutput()) {
+        resam.resample(rng, s.logWeights(), s.ancestors(), s.getDyn());
+        bi::gather(s.ancestors(), s.getStep(), s.getStep());
+      } else {
+        typename S1::temp_int_vector_type as1(s.ancestors().size());
+        resam.resample(rng, s.logWeights(), as1, s.getDyn());
+        bi::gather(as1, s.getStep(), s.getStep());
+        bi::gather(as1, s.ancestors(), s.ancestors());
+      }
+    } else {
+      seq_elements(s.ancestors(), 0);
+      Resampler::normalise(s.logWeights(), lW);
+    }
+  } else if (now.hasOutput()) {
+    seq_elements(s.ancestors(), 0);
+  }
+  return split;
+}
+
+template<class B, class S, class R>
+template<class V1, class V2>
+void bi::BootstrapPF<B,S,R>::ancestorsPermute(Random& rng, const V1 lws,
+    V2 as, boost::mpl::true_) {
+  resam.ancestorsPermute(rng, lws, as);
+}
+
+template<class B, class S, class R>
+template<class V1, class V2>
+void bi::BootstrapPF<B,S,R>::ancestorsPermute(Random& rng, const V1 lws,
+    V2 as, boost::mpl::false_) {
+  BI_ASSERT(false);
+}
+
 template<class B, class S, class R>
 template<class S1>
 void bi::BootstrapPF<B,S,R>::predict(Random& rng, const ScheduleElement next,
@@ -298,35 +551,82 @@ double bi::BootstrapPF<B,S,R>::correct(Random& rng, const ScheduleElement now,
     S1& s) {
   double ll = 0.0;
   if (now.isObserved()) {
+    /* log-weights reduced in the same pass as they are updated */
+    real mx, sum1, sum2;
     m.observationLogDensities(s, sim.obs.getMask(now.indexObs()),
-        s.logWeights());
-    ll = logsumexp_reduce(s.logWeights())
+        s.logWeights(), mx, sum1, sum2);
+    ll = mx + bi::log(static_cast<double>(sum1))
         - bi::log(static_cast<double>(s.size()));
   }
   return ll;
 }
 
+template<class B, class S, class R>
+template<class S1>
+double bi::BootstrapPF<B,S,R>::getMaxLogLikelihood(
+    const ScheduleElement now, S1& s) {
+  return now.isObserved() ? getMaxLogWeight(now, s) : 0.0;
+}
+
+template<class B, class S, class R>
+template<class S1>
+void bi::BootstrapPF<B,S,R>::getMaxLogLikelihoods(
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    std::vector<double>& maxlls) {
+  const int start = s.start();
+  const int size = s.size();
+  State<B,S1::location> s1;
+  ScheduleIterator iter;
+  int i;
+
+  s.setRange(start, 1);
+  s1 = s;
+  s.setRange(start, size);
+
+  std::vector<double> lls(last - first, 0.0);
+  for (iter = first + 1; iter != last; ++iter) {
+    if (iter->hasInput()) {
+      sim.in.update(iter->indexInput(), s1);
+    }
+    if (iter->hasObs()) {
+      sim.obs.update(iter->indexObs(), s1);
+    }
+    lls[iter - first] = getMaxLogLikelihood(*iter, s1);
+  }
+
+  maxlls.resize(last - first);
+  maxlls.back() = 0.0;
+  for (i = (int)maxlls.size() - 2; i >= 0; --i) {
+    maxlls[i] = maxlls[i + 1] + lls[i + 1];
+  }
+}
+
 template<class B, class S, class R>
 template<class S1>
 bool bi::BootstrapPF<B,S,R>::resample(Random& rng, const ScheduleElement now,
     S1& s) {
   bool r = now.isObserved();
   if (r) {
-    r = resam.isTriggered(s.logWeights());
+    /* single pass over weights for both trigger and normalisation */
+    double lW, ess;
+    resam.reduce(s.logWeights(), lW, ess);
+    r = resam.isTriggered(ess, s.size());
     if (r) {
       if (resampler_needs_max<R>::value) {
         resam.setMaxLogWeight(getMaxLogWeight(now, s));
       }
       if (now.hasOutput()) {
         resam.resample(rng, s.logWeights(), s.ancestors(), s.getDyn());
+        bi::gather(s.ancestors(), s.getStep(), s.getStep());
       } else {
         typename S1::temp_int_vector_type as1(s.ancestors().size());
         resam.resample(rng, s.logWeights(), as1, s.getDyn());
+        bi::gather(as1, s.getStep(), s.getStep());
         bi::gather(as1, s.ancestors(), s.ancestors());
       }
     } else {
       seq_elements(s.ancestors(), 0);
-      Resampler::normalise(s.logWeights());
+      Resampler::normalise(s.logWeights(), lW);
     }
   } else if (now.hasOutput()) {
     seq_elements(s.ancestors(), 0);
@@ -15,6 +15,8 @@
 #include "../misc/location.hpp"
 #include "../misc/exception.hpp"
 
+#include <vector>
+
 namespace bi {
 /**
  * Extended Kalman filter.
@@ -121,6 +123,22 @@ public:
   double correct(Random& rng, const ScheduleElement now, S1& s)
       throw (CholeskyException);
 
+  /**
+   * @copydoc BootstrapPF::getMaxLogLikelihood()
+   *
+   * The innovation covariance is not known in advance, so that no bound is
+   * available, and infinity is returned.
+   */
+  template<class S1>
+  double getMaxLogLikelihood(const ScheduleElement now, S1& s);
+
+  /**
+   * @copydoc BootstrapPF::getMaxLogLikelihoods()
+   */
+  template<class S1>
+  void getMaxLogLikelihoods(const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, std::vector<double>& maxlls);
+
   /**
    * Output static variables.
    *
@@ -191,6 +209,8 @@ protected:
 #include "../math/loc_temp_vector.hpp"
 #include "../math/loc_temp_matrix.hpp"
 
+#include <limits>
+
 template<class B, class S>
 bi::ExtendedKF<B,S>::ExtendedKF(B& m, S& sim) :
     m(m), sim(sim) {
@@ -411,6 +431,24 @@ double bi::ExtendedKF<B,S>::correct(Random& rng, const ScheduleElement now,
   return ll;
 }
 
+template<class B, class S>
+template<class S1>
+double bi::ExtendedKF<B,S>::getMaxLogLikelihood(const ScheduleElement now,
+    S1& s) {
+  return now.isObserved() ? std::numeric_limits<double>::infinity() : 0.0;
+}
+
+template<class B, class S>
+template<class S1>
+void bi::ExtendedKF<B,S>::getMaxLogLikelihoods(const ScheduleIterator first,
+    const ScheduleIterator last, S1& s, std::vector<double>& maxlls) {
+  maxlls.resize(last - first);
+  maxlls.back() = 0.0;
+  for (int i = (int)maxlls.size() - 2; i >= 0; --i) {
+    maxlls[i] = maxlls[i + 1] + getMaxLogLikelihood(first[i + 1], s);
+  }
+}
+
 template<class B, class S>
 template<class S1, class IO1>
 void bi::ExtendedKF<B,S>::output0(const S1& s, IO1& out) {
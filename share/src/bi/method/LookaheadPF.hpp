@@ -11,6 +11,8 @@
 #include "BootstrapPF.hpp"
 #include "../state/AuxiliaryPFState.hpp"
 
+#include <vector>
+
 namespace bi {
 /**
  * Auxiliary particle filter with lookahead.
@@ -85,6 +87,22 @@ public:
   template<class S1>
   double correct(Random& rng, const ScheduleElement now, S1& s);
 
+  /**
+   * @copydoc BootstrapPF::getMaxLogLikelihood()
+   *
+   * Lookahead weights are removed again on correction, so that no bound is
+   * available, and infinity is returned.
+   */
+  template<class S1>
+  double getMaxLogLikelihood(const ScheduleElement now, S1& s);
+
+  /**
+   * @copydoc BootstrapPF::getMaxLogLikelihoods()
+   */
+  template<class S1>
+  void getMaxLogLikelihoods(const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, std::vector<double>& maxlls);
+
   /**
    * @copydoc BootstrapPF::resample()
    */
@@ -113,6 +131,8 @@ protected:
 #include "../primitive/vector_primitive.hpp"
 #include "../primitive/matrix_primitive.hpp"
 
+#include <limits>
+
 template<class B, class S, class R>
 bi::LookaheadPF<B,S,R>::LookaheadPF(B& m, S& sim, R& resam) :
     BootstrapPF<B,S,R>(m, sim, resam) {
@@ -203,15 +223,35 @@ double bi::LookaheadPF<B,S,R>::correct(Random& rng, const ScheduleElement now,
     axpy(-1.0, s.logAuxWeights(), s.logWeights());
     s.logAuxWeights().clear();
 
+    real mx, sum1, sum2;
     this->m.observationLogDensities(s, this->sim.obs.getMask(now.indexObs()),
-        s.logWeights());
+        s.logWeights(), mx, sum1, sum2);
 
-    ll = logsumexp_reduce(s.logWeights())
+    ll = mx + bi::log(static_cast<double>(sum1))
         - bi::log(static_cast<double>(s.size()));
   }
   return ll;
 }
 
+template<class B, class S, class R>
+template<class S1>
+double bi::LookaheadPF<B,S,R>::getMaxLogLikelihood(
+    const ScheduleElement now, S1& s) {
+  return now.isObserved() ? std::numeric_limits<double>::infinity() : 0.0;
+}
+
+template<class B, class S, class R>
+template<class S1>
+void bi::LookaheadPF<B,S,R>::getMaxLogLikelihoods(
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    std::vector<double>& maxlls) {
+  maxlls.resize(last - first);
+  maxlls.back() = 0.0;
+  for (int i = (int)maxlls.size() - 2; i >= 0; --i) {
+    maxlls[i] = maxlls[i + 1] + getMaxLogLikelihood(first[i + 1], s);
+  }
+}
+
 template<class B, class S, class R>
 template<class S1>
 bool bi::LookaheadPF<B,S,R>::resample(Random& rng, const ScheduleElement now,
@@ -226,10 +266,12 @@ bool bi::LookaheadPF<B,S,R>::resample(Random& rng, const ScheduleElement now,
       if (now.hasOutput()) {
         this->resam.resample(rng, s.logWeights(), s.ancestors(), s.getDyn());
         bi::gather(s.ancestors(), s.logAuxWeights(), s.logAuxWeights());
+        bi::gather(s.ancestors(), s.getStep(), s.getStep());
       } else {
         typename S1::temp_int_vector_type as1(s.ancestors().size());
         this->resam.resample(rng, s.logWeights(), as1, s.getDyn());
         bi::gather(as1, s.logAuxWeights(), s.logAuxWeights());
+        bi::gather(as1, s.getStep(), s.getStep());
         bi::gather(as1, s.ancestors(), s.ancestors());
       }
     } else {
@@ -245,10 +287,12 @@ bool bi::LookaheadPF<B,S,R>::resample(Random& rng, const ScheduleElement now,
       if (now.hasOutput()) {
         this->resam.resample(rng, s.logWeights(), s.ancestors(), s.getDyn());
         bi::gather(s.ancestors(), s.logAuxWeights(), s.logAuxWeights());
+        bi::gather(s.ancestors(), s.getStep(), s.getStep());
       } else {
         typename S1::temp_int_vector_type as1(s.ancestors().size());
         this->resam.resample(rng, s.logWeights(), as1, s.getDyn());
         bi::gather(as1, s.logAuxWeights(), s.logAuxWeights());
+        bi::gather(as1, s.getStep(), s.getStep());
         bi::gather(as1, s.ancestors(), s.ancestors());
       }
     } else {
@@ -0,0 +1,438 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_METHOD_MARGINALDAMH_HPP
+#define BI_METHOD_MARGINALDAMH_HPP
+
+#include "../state/Schedule.hpp"
+#include "../misc/exception.hpp"
+
+#include <limits>
+
+namespace bi {
+/**
+ * Marginal delayed-acceptance Metropolis-Hastings.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ * @tparam G Surrogate filter type.
+ *
+ * As MarginalMH, but each proposal is first screened with a cheap surrogate
+ * estimate of the marginal likelihood, typically from ExtendedKF. Only
+ * proposals that pass the screen are passed to the filter. The second
+ * acceptance ratio includes the reciprocal surrogate likelihood ratio, which
+ * corrects for the screen, so that the chain still targets the posterior.
+ *
+ * Where the surrogate fails, at either the current or the proposed state,
+ * the screen is skipped and the proposal accepted or rejected with the
+ * usual Metropolis--Hastings ratio. The condition is symmetric in the two
+ * states, so that the chain still targets the full posterior, including
+ * where the surrogate fails.
+ */
+template<class B, class F, class G>
+class MarginalDAMH {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   * @param surrogate Surrogate filter.
+   */
+  MarginalDAMH(B& m, F& filter, G& surrogate);
+
+  /**
+   * @name High-level interface.
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * @copydoc MarginalMH::sample()
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+  //@}
+
+  /**
+   * @name Low-level interface.
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise starting state.
+   *
+   * @tparam S1 State type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s State.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO2>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, IO2& inInit);
+
+  /**
+   * Propose new state, and estimate its marginal likelihood under the
+   * surrogate filter.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void propose(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s);
+
+  /**
+   * First stage: accept or reject proposed state using the surrogate
+   * marginal likelihood.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param s State.
+   *
+   * @return Was the proposal accepted, and so should be passed to the second
+   * stage?
+   */
+  template<class S1>
+  bool screen(Random& rng, S1& s);
+
+  /**
+   * Estimate marginal likelihood of proposed state using the filter.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[in,out] s State.
+   */
+  template<class S1>
+  void estimate(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s);
+
+  /**
+   * Second stage: accept or reject proposed state, correcting for the
+   * first stage.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param s State.
+   *
+   * @return Was the proposal accepted?
+   */
+  template<class S1>
+  bool acceptReject(Random& rng, S1& s);
+
+  /**
+   * @copydoc MarginalMH::output()
+   */
+  template<class S1, class IO1>
+  void output(const int c, S1& s, IO1& out);
+
+  /**
+   * @copydoc MarginalMH::report()
+   */
+  template<class S1>
+  void report(const int c, S1& s);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+private:
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Surrogate filter.
+   */
+  G& surrogate;
+
+  /**
+   * Was the last proposal passed without screening, as the surrogate failed
+   * at the current or proposed state?
+   */
+  bool unscreened;
+
+  /**
+   * Was the last proposal accepted?
+   */
+  bool lastAccepted;
+
+  /**
+   * Number of accepted proposals.
+   */
+  int accepted;
+
+  /**
+   * Number of proposals that passed the first stage.
+   */
+  int screened;
+
+  /**
+   * Total number of proposals.
+   */
+  int total;
+};
+}
+
+template<class B, class F, class G>
+bi::MarginalDAMH<B,F,G>::MarginalDAMH(B& m, F& filter, G& surrogate) :
+    m(m), filter(filter), surrogate(surrogate), unscreened(false),
+    lastAccepted(false), accepted(0), screened(0), total(0) {
+  //
+}
+
+template<class B, class F, class G>
+template<class S1, class IO1, class IO2>
+void bi::MarginalDAMH<B,F,G>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  init(rng, first, last, s, inInit);
+  output(0, s, out);
+  for (int c = 1; c < C; ++c) {
+    propose(rng, first, last, s);
+    if (screen(rng, s)) {
+      estimate(rng, first, last, s);
+      acceptReject(rng, s);
+    } else {
+      lastAccepted = false;
+      ++total;
+    }
+    report(c, s);
+    output(c, s, out);
+  }
+  term();
+}
+
+template<class B, class F, class G>
+template<class S1, class IO2>
+void bi::MarginalDAMH<B,F,G>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    IO2& inInit) {
+  /* log-likelihood */
+  s.theta1.logLikelihood = filter.filter(rng, first, last, s.theta1,
+      s.theta1.out, inInit);
+
+  /* prior log-density */
+  s.theta1.get(PY_VAR) = s.theta1.get(P_VAR);
+  s.theta1.logPrior = m.parameterLogDensity(s.theta1);
+
+  /* surrogate log-likelihood, at the same parameters */
+  s.eta1.get(P_VAR) = s.theta1.get(P_VAR);
+  s.eta1.logLikelihood = -std::numeric_limits<real>::infinity();
+  try {
+    s.eta1.logLikelihood = surrogate.filter(rng, first, last, s.eta1,
+        s.eta1.out);
+  } catch (CholeskyException e) {
+    //
+  }
+
+  /* path */
+  filter.samplePath(rng, s.theta1.path, s.theta1.out);
+  lastAccepted = true;
+  accepted = 1;
+  screened = 1;
+  total = 1;
+}
+
+template<class B, class F, class G>
+template<class S1>
+void bi::MarginalDAMH<B,F,G>::propose(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s) {
+  /* proposal */
+  s.theta2.get(P_VAR) = s.theta1.get(P_VAR);
+  m.proposalParameterSample(rng, s.theta2);
+
+  /* reverse proposal log-density */
+  s.theta1.get(PY_VAR) = s.theta1.get(P_VAR);
+  s.theta1.get(P_VAR) = s.theta2.get(P_VAR);
+  s.theta1.logProposal = m.proposalParameterLogDensity(s.theta1);
+
+  /* proposal log-density */
+  s.theta2.get(PY_VAR) = s.theta2.get(P_VAR);
+  s.theta2.get(P_VAR) = s.theta1.get(P_VAR);
+  s.theta2.logProposal = m.proposalParameterLogDensity(s.theta2);
+
+  /* prior log-density */
+  s.theta2.get(PY_VAR) = s.theta2.get(P_VAR);
+  s.theta2.logPrior = m.parameterLogDensity(s.theta2);
+
+  /* surrogate log-likelihood */
+  s.eta2.logLikelihood = -std::numeric_limits<real>::infinity();
+  if (bi::is_finite(s.theta2.logPrior)) {
+    s.eta2.get(P_VAR) = s.theta2.get(P_VAR);
+    try {
+      s.eta2.logLikelihood = surrogate.filter(rng, first, last, s.eta2,
+          s.eta2.out);
+    } catch (CholeskyException e) {
+      //
+    }
+  }
+  s.theta2.logLikelihood = -std::numeric_limits<real>::infinity();
+}
+
+template<class B, class F, class G>
+template<class S1>
+bool bi::MarginalDAMH<B,F,G>::screen(Random& rng, S1& s) {
+  bool pass;
+  unscreened = !bi::is_finite(s.eta1.logLikelihood)
+      || !bi::is_finite(s.eta2.logLikelihood);
+  if (!bi::is_finite(s.theta2.logPrior)) {
+    pass = false;
+  } else if (unscreened) {
+    /* surrogate failed, defer to the second stage */
+    pass = true;
+  } else {
+    double loglr = s.eta2.logLikelihood - s.eta1.logLikelihood;
+    double logpr = s.theta2.logPrior - s.theta1.logPrior;
+    double logqr = s.theta1.logProposal - s.theta2.logProposal;
+
+    if (!bi::is_finite(s.theta1.logProposal)
+        && !bi::is_finite(s.theta2.logProposal)) {
+      logqr = 0.0;
+    }
+    double logratio = loglr + logpr + logqr;
+    double u = rng.uniform<double>();
+
+    pass = bi::log(u) < logratio;
+  }
+
+  if (pass) {
+    ++screened;
+  }
+  return pass;
+}
+
+template<class B, class F, class G>
+template<class S1>
+void bi::MarginalDAMH<B,F,G>::estimate(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s) {
+  s.theta2.logLikelihood = -std::numeric_limits<real>::infinity();
+  try {
+    s.theta2.logLikelihood = filter.filter(rng, first, last, s.theta2,
+        s.theta2.out);
+  } catch (CholeskyException e) {
+    //
+  } catch (ParticleFilterDegeneratedException e) {
+    //
+  }
+}
+
+template<class B, class F, class G>
+template<class S1>
+bool bi::MarginalDAMH<B,F,G>::acceptReject(Random& rng, S1& s) {
+  if (!bi::is_finite(s.theta2.logLikelihood)) {
+    lastAccepted = false;
+  } else if (!bi::is_finite(s.theta1.logLikelihood)) {
+    lastAccepted = true;
+  } else {
+    double loglr = s.theta2.logLikelihood - s.theta1.logLikelihood;
+    double logratio;
+    if (unscreened) {
+      /* plain Metropolis-Hastings ratio */
+      double logpr = s.theta2.logPrior - s.theta1.logPrior;
+      double logqr = s.theta1.logProposal - s.theta2.logProposal;
+      if (!bi::is_finite(s.theta1.logProposal)
+          && !bi::is_finite(s.theta2.logProposal)) {
+        logqr = 0.0;
+      }
+      logratio = loglr + logpr + logqr;
+    } else {
+      /* prior and proposal terms were accounted for in the first stage */
+      double logsr = s.eta1.logLikelihood - s.eta2.logLikelihood;
+      logratio = loglr + logsr;
+    }
+    double u = rng.uniform<double>();
+
+    lastAccepted = bi::log(u) < logratio;
+  }
+
+  if (lastAccepted) {
+    filter.samplePath(rng, s.theta2.path, s.theta2.out);
+    s.theta2.swap(s.theta1);
+    s.eta2.swap(s.eta1);
+    ++accepted;
+  }
+  ++total;
+
+  return lastAccepted;
+}
+
+template<class B, class F, class G>
+template<class S1, class IO1>
+void bi::MarginalDAMH<B,F,G>::output(const int c, S1& s, IO1& out) {
+  out.write(c, s.theta1);
+  if (out.isFull()) {
+    out.flush();
+    out.clear();
+  }
+}
+
+template<class B, class F, class G>
+template<class S1>
+void bi::MarginalDAMH<B,F,G>::report(const int c, S1& s) {
+  std::cerr << c << ":\t";
+  std::cerr.width(10);
+  std::cerr << s.theta1.logLikelihood;
+  std::cerr << '\t';
+  std::cerr.width(10);
+  std::cerr << s.eta1.logLikelihood;
+  std::cerr << '\t';
+  std::cerr.width(10);
+  std::cerr << s.theta1.logPrior;
+  std::cerr << "\tbeats\t";
+  std::cerr.width(10);
+  std::cerr << s.theta2.logLikelihood;
+  std::cerr << '\t';
+  std::cerr.width(10);
+  std::cerr << s.eta2.logLikelihood;
+  std::cerr << '\t';
+  std::cerr.width(10);
+  std::cerr << s.theta2.logPrior;
+  std::cerr << '\t';
+  if (lastAccepted) {
+    std::cerr << "accept";
+  }
+  std::cerr << "\tscreen=" << (double)screened / total;
+  std::cerr << "\taccept=" << (double)accepted / total;
+  std::cerr << std::endl;
+}
+
+template<class B, class F, class G>
+void bi::MarginalDAMH<B,F,G>::term() {
+  //
+}
+
+#endif
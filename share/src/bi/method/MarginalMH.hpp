@@ -10,6 +10,11 @@
 
 #include "../state/Schedule.hpp"
 #include "../misc/exception.hpp"
+#include "../random/Random.hpp"
+#include "../random/ReplayStream.hpp"
+
+#include <vector>
+#include <limits>
 
 namespace bi {
 /**
@@ -24,6 +29,28 @@ namespace bi {
  * with a particle filter, gives the particle marginal Metropolis--Hastings
  * sampler described in @ref Andrieu2010 "Andrieu, Doucet \& Holenstein (2010)".
  *
+ * The uniform variate of the acceptance test is drawn before the filter is
+ * run for a proposal, so that the log-likelihood needed for acceptance is
+ * known in advance. The filter is terminated early, and the proposal
+ * rejected, once the log-likelihood so far plus an upper bound on the
+ * increments still to come (see BootstrapPF::getMaxLogLikelihoods()) can no
+ * longer exceed it. The bound of each step is computed with the inputs and
+ * observations of its own time. The accept/reject decision is unchanged by
+ * this, provided that the maximum log-density of the observations does not
+ * depend on the state variables.
+ *
+ * With a nonzero correlation, gives the correlated pseudo-marginal method
+ * of @ref Deligiannidis2018 "Deligiannidis, Doucet \& Pitt (2018)": the
+ * filter is run in a replay of a ReplayStream (see Random::startReplay()),
+ * so that its auxiliary variates, for noise and resampling, are those of the
+ * current state moved by a Crank--Nicolson step, rather than drawn afresh.
+ * The variates are kept with the state on acceptance. The log-likelihood
+ * estimates of the current and proposed states are then correlated, and
+ * fewer particles are needed for the same acceptance rate. The proposal,
+ * acceptance test and path sampling use fresh variates. This is best
+ * combined with a resampler that orders particles by state, such as
+ * HilbertResampler, so that ancestors change smoothly with the variates.
+ *
  * @todo Add proposal adaptation using adapter classes.
  */
 template<class B, class F>
@@ -34,8 +61,10 @@ public:
    *
    * @param m Model.
    * @param filter Filter.
+   * @param rho Correlation of auxiliary variates between the current and
+   * proposed states. Zero draws them afresh for each proposal.
    */
-  MarginalMH(B& m, F& filter);
+  MarginalMH(B& m, F& filter, const real rho = 0.0);
 
   /**
    * @name High-level interface.
@@ -87,7 +116,8 @@ public:
       const ScheduleIterator last, S1& theta1, IO2& inInit);
 
   /**
-   * Propose new state.
+   * Propose new state. Also draws the uniform variate used by
+   * acceptReject().
    *
    * @tparam S1 State type.
    *
@@ -163,6 +193,25 @@ public:
   //@}
 
 private:
+  /**
+   * Filter, terminating early once the log-likelihood estimate can no longer
+   * exceed a threshold.
+   *
+   * @tparam S1 State type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s State.
+   * @param llmin Threshold.
+   *
+   * @return Estimate of the marginal log-likelihood, or negative infinity if
+   * terminated early.
+   */
+  template<class S1>
+  double filterBounded(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const double llmin);
+
   /**
    * Model.
    */
@@ -173,6 +222,21 @@ private:
    */
   F& filter;
 
+  /**
+   * Auxiliary variates of the filter, for correlated proposals.
+   */
+  ReplayStream aux;
+
+  /**
+   * Are proposals correlated?
+   */
+  bool correlated;
+
+  /**
+   * Log of uniform variate for acceptance test of the last proposal.
+   */
+  double logU;
+
   /**
    * Was the last proposal accepted?
    */
@@ -191,8 +255,9 @@ private:
 }
 
 template<class B, class F>
-bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter) :
-    m(m), filter(filter), lastAccepted(false), accepted(0), total(0) {
+bi::MarginalMH<B,F>::MarginalMH(B& m, F& filter, const real rho) :
+    m(m), filter(filter), aux(rho), correlated(rho > 0.0), logU(0.0),
+    lastAccepted(false), accepted(0), total(0) {
   //
 }
 
@@ -219,8 +284,17 @@ template<class S1, class IO2>
 void bi::MarginalMH<B,F>::init(Random& rng, const ScheduleIterator first,
     const ScheduleIterator last, S1& theta1, IO2& inInit) {
   /* log-likelihood */
-  theta1.logLikelihood = filter.filter(rng, first, last, theta1, theta1.out,
-      inInit);
+  if (correlated) {
+    {
+      ReplayScope replay(rng, aux);
+      theta1.logLikelihood = filter.filter(rng, first, last, theta1,
+          theta1.out, inInit);
+    }
+    aux.accept();
+  } else {
+    theta1.logLikelihood = filter.filter(rng, first, last, theta1,
+        theta1.out, inInit);
+  }
 
   /* prior log-density */
   theta1.get(PY_VAR) = theta1.get(P_VAR);
@@ -255,12 +329,26 @@ void bi::MarginalMH<B,F>::propose(Random& rng, const ScheduleIterator first,
   theta2.get(PY_VAR) = theta2.get(P_VAR);
   theta2.logPrior = m.parameterLogDensity(theta2);
 
+  /* log-likelihood needed for acceptance */
+  logU = bi::log(rng.uniform<double>());
+  double llmin = -std::numeric_limits<double>::infinity();
+  if (bi::is_finite(theta1.logLikelihood)) {
+    double logpr = theta2.logPrior - theta1.logPrior;
+    double logqr = theta1.logProposal - theta2.logProposal;
+    if (!bi::is_finite(theta1.logProposal)
+        && !bi::is_finite(theta2.logProposal)) {
+      logqr = 0.0;
+    }
+    llmin = theta1.logLikelihood + logU - logpr - logqr;
+  }
+
   /* log-likelihood */
   theta2.logLikelihood = -std::numeric_limits<real>::infinity();
   if (bi::is_finite(theta2.logPrior)) {
+    /* replay stopped however the filter is left */
+    ReplayScope replay(rng, aux, correlated);
     try {
-      theta2.logLikelihood = filter.filter(rng, first, last, theta2,
-          theta2.out);
+      theta2.logLikelihood = filterBounded(rng, first, last, theta2, llmin);
     } catch (CholeskyException e) {
       //
     } catch (ParticleFilterDegeneratedException e) {
@@ -286,11 +374,17 @@ bool bi::MarginalMH<B,F>::acceptReject(Random& rng, S1& theta1, S1& theta2) {
       logqr = 0.0;
     }
     double logratio = loglr + logpr + logqr;
-    double u = rng.uniform<double>();
 
-    lastAccepted = bi::log(u) < logratio;
+    lastAccepted = logU < logratio;
   }
 
+  if (correlated) {
+    if (lastAccepted) {
+      aux.accept();
+    } else {
+      aux.reject();
+    }
+  }
   if (lastAccepted) {
     filter.samplePath(rng, theta2.path, theta2.out);
     theta2.swap(theta1);
@@ -313,6 +407,40 @@ double bi::MarginalMH<B,F>::extend(Random& rng, ScheduleIterator& iter,
   return ll;
 }
 
+template<class B, class F>
+template<class S1>
+double bi::MarginalMH<B,F>::filterBounded(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const double llmin) {
+  const bool bounded = bi::is_finite(llmin);
+  ScheduleIterator iter = first;
+  double ll;
+
+  filter.init(rng, *iter, s, s.out);
+
+  /* upper bounds on the sum of log-likelihood increments after each step in
+   * the schedule */
+  std::vector<double> maxlls;
+  if (bounded) {
+    filter.getMaxLogLikelihoods(first, last, s, maxlls);
+  }
+
+  filter.output0(s, s.out);
+  ll = filter.correct(rng, *iter, s);
+  filter.output(*iter, s, s.out);
+  while (iter + 1 != last && (!bounded || ll + maxlls[iter - first] > llmin)) {
+    ll += filter.step(rng, iter, last, s, s.out);
+  }
+  filter.term();
+  if (iter + 1 != last) {
+    /* terminated early, cannot be accepted */
+    ll = -std::numeric_limits<double>::infinity();
+  }
+  filter.outputT(ll, s.out);
+
+  return ll;
+}
+
 template<class B, class F>
 template<class S1, class IO1>
 void bi::MarginalMH<B,F>::output(const int c, S1& s, IO1& out) {
@@ -0,0 +1,244 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_METHOD_MARGINALMHCHAINS_HPP
+#define BI_METHOD_MARGINALMHCHAINS_HPP
+
+#include "MarginalMH.hpp"
+#include "../state/Schedule.hpp"
+#include "../misc/omp.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Multiple chains of marginal Metropolis-Hastings, run concurrently.
+ *
+ * @ingroup method_sampler
+ *
+ * @tparam B Model type
+ * @tparam F Filter type.
+ *
+ * Each chain is a MarginalMH sampler with its own state, and runs on one
+ * thread. Nested parallelism is disabled (see bi_omp_init()), so that the
+ * filter of each chain then runs single-threaded, with the random number
+ * generator of its thread. The chains share the filter, and so the inputs,
+ * observations and time schedule, which are read once. As for
+ * MarginalSIR, the filter must not write to common state once its caches
+ * are filled; this excludes AdaptivePF, which updates its stopper.
+ *
+ * The samples of chain @c k are written to indices
+ * <tt>[k*C, (k + 1)*C)</tt> of the output buffer, where @c C is the number
+ * of samples in each chain. Each chain collects samples in its own cache,
+ * and writes them to the output buffer a block at a time, one chain after
+ * another.
+ */
+template<class B, class F>
+class MarginalMHChains {
+public:
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param filter Filter.
+   */
+  MarginalMHChains(B& m, F& filter);
+
+  /**
+   * Destructor.
+   */
+  ~MarginalMHChains();
+
+  /**
+   * @name High-level interface.
+   *
+   * An easier interface for common usage.
+   */
+  //@{
+  /**
+   * Sample.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param s State.
+   * @param C Number of samples to draw in each chain.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void sample(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out, IO2& inInit);
+  //@}
+
+  /**
+   * @name Low-level interface.
+   *
+   * Largely used by other features of the library or for finer control over
+   * performance and behaviour.
+   */
+  //@{
+  /**
+   * Initialise starting state of all chains, and output it.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   * @tparam IO2 Input type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param[out] s State.
+   * @param C Number of samples to draw in each chain.
+   * @param out Output buffer.
+   * @param inInit Initialisation file.
+   */
+  template<class S1, class IO1, class IO2>
+  void init(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, S1& s, const int C, IO1& out,
+      IO2& inInit);
+
+  /**
+   * Run one chain after its initialisation.
+   *
+   * @tparam S1 State type.
+   * @tparam IO1 Output type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param first Start of time schedule.
+   * @param last End of time schedule.
+   * @param k Index of chain.
+   * @param[in,out] s State.
+   * @param C Number of samples to draw in each chain.
+   * @param out Output buffer.
+   */
+  template<class S1, class IO1>
+  void run(Random& rng, const ScheduleIterator first,
+      const ScheduleIterator last, const int k, S1& s, const int C,
+      IO1& out);
+
+  /**
+   * Terminate.
+   */
+  void term();
+  //@}
+
+private:
+  /**
+   * Model.
+   */
+  B& m;
+
+  /**
+   * Filter.
+   */
+  F& filter;
+
+  /**
+   * Samplers, one for each chain.
+   */
+  std::vector<MarginalMH<B,F>*> mmhs;
+};
+}
+
+template<class B, class F>
+bi::MarginalMHChains<B,F>::MarginalMHChains(B& m, F& filter) :
+    m(m), filter(filter) {
+  //
+}
+
+template<class B, class F>
+bi::MarginalMHChains<B,F>::~MarginalMHChains() {
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::MarginalMHChains<B,F>::sample(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  /* pre-condition */
+  BI_ERROR(C > 0);
+
+  int k;
+  init(rng, first, last, s, C, out, inInit);
+  if (!S1::on_device) {
+    #pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < s.size(); ++k) {
+      run(rng, first, last, k, s, C, out);
+    }
+  } else {
+    for (k = 0; k < s.size(); ++k) {
+      run(rng, first, last, k, s, C, out);
+    }
+  }
+  term();
+}
+
+template<class B, class F>
+template<class S1, class IO1, class IO2>
+void bi::MarginalMHChains<B,F>::init(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, S1& s,
+    const int C, IO1& out, IO2& inInit) {
+  term();
+
+  /* chains are initialised one after the other, as this reads the
+   * initialisation file; the first also fills the caches of inputs and
+   * observations for all times, so that the chains may then run
+   * concurrently without writing to them */
+  mmhs.resize(s.size());
+  for (int k = 0; k < s.size(); ++k) {
+    mmhs[k] = new MarginalMH<B,F>(m, filter);
+    mmhs[k]->init(rng, first, last, s.chains[k]->theta1, inInit);
+    out.write(k*C, s.chains[k]->theta1);
+    out.flush();
+    out.clear();
+  }
+}
+
+template<class B, class F>
+template<class S1, class IO1>
+void bi::MarginalMHChains<B,F>::run(Random& rng,
+    const ScheduleIterator first, const ScheduleIterator last, const int k,
+    S1& s, const int C, IO1& out) {
+  MarginalMH<B,F>& mmh = *mmhs[k];
+  typename S1::chain_type& chain = *s.chains[k];
+  typename S1::cache_type& cache = *s.caches[k];
+
+  for (int c = 1; c < C; ++c) {
+    mmh.propose(rng, first, last, chain.theta1, chain.theta2);
+    mmh.acceptReject(rng, chain.theta1, chain.theta2);
+    if (k == 0) {
+      mmh.report(c, chain);
+    }
+    cache.write(c, chain.theta1);
+    if (cache.isFull() || c == C - 1) {
+      /* output buffer is shared by all chains */
+      #pragma omp critical(bi_mcmc_chains_output)
+      {
+        out.writeCache(k*C, cache);
+        out.flush();
+        out.clear();
+      }
+      cache.clear();
+    }
+  }
+}
+
+template<class B, class F>
+void bi::MarginalMHChains<B,F>::term() {
+  for (int k = 0; k < int(mmhs.size()); ++k) {
+    delete mmhs[k];
+  }
+  mmhs.clear();
+}
+
+#endif
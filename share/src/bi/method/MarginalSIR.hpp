@@ -13,6 +13,7 @@
 #include "../state/Schedule.hpp"
 #include "../misc/exception.hpp"
 #include "../primitive/vector_primitive.hpp"
+#include "../misc/omp.hpp"
 
 namespace bi {
 /**
@@ -29,6 +30,15 @@ namespace bi {
  * combined with a particle filter, gives the SMC^2 method described in
  * @ref Chopin2013 "Chopin, Jacob \& Papaspiliopoulos (2013)".
  *
+ * On host, the \f$\theta\f$-particles may optionally be extended and
+ * rejuvenated concurrently, one thread each, rather than one after the
+ * other with each filter using all threads. Nested parallelism is disabled
+ * (see bi_omp_init()), so that the filter of each \f$\theta\f$-particle
+ * then runs on a single thread, with the random number generator of that
+ * thread. The filter and its simulator are shared among threads, so that
+ * they must not write to common state once their caches are filled; this
+ * excludes AdaptivePF, which updates its stopper.
+ *
  * @todo Add support for adapter classes.
  * @todo Add support for stopper classes for theta particles.
  */
@@ -43,11 +53,15 @@ public:
    * @param adapter Adapter.
    * @param resam Resampler for theta-particles.
    * @param Nmoves Number of steps per \f$\theta\f$-particle.
+   * @param parallel Extend and rejuvenate \f$\theta\f$-particles
+   * concurrently? If so, the state must be constructed for parallel
+   * rejuvenation too, see MarginalSIRState.
    * @param adapter Proposal adaptation strategy.
    * @param adapterScale Scaling factor for local proposals.
    * @param out Output.
    */
-  MarginalSIR(B& m, F& mmh, A& adapter, R& resam, const int Nmoves = 1);
+  MarginalSIR(B& m, F& mmh, A& adapter, R& resam, const int Nmoves = 1,
+      const bool parallel = false);
 
   /**
    * @name High-level interface.
@@ -181,13 +195,19 @@ private:
    * Number of PMMH steps when rejuvenating.
    */
   int Nmoves;
+
+  /**
+   * Extend and rejuvenate theta-particles concurrently?
+   */
+  bool parallel;
 };
 }
 
 template<class B, class F, class A, class R>
 bi::MarginalSIR<B,F,A,R>::MarginalSIR(B& m, F& mmh, A& adapter, R& resam,
-    const int Nmoves) :
-    m(m), mmh(mmh), adapter(adapter), resam(resam), Nmoves(Nmoves) {
+    const int Nmoves, const bool parallel) :
+    m(m), mmh(mmh), adapter(adapter), resam(resam), Nmoves(Nmoves),
+    parallel(parallel) {
   //
 }
 
@@ -239,9 +259,47 @@ double bi::MarginalSIR<B,F,A,R>::step(Random& rng,
   report(*iter, ess, r, acceptRate);
 
   ScheduleIterator iter1;
-  for (p = 0; p < s.size(); ++p) {
+  if (parallel && !S1::on_device) {
+    /* the first theta-particle is extended alone, filling the caches of
+     * inputs and observations for the new times, so that the rest may be
+     * extended concurrently without writing to them */
     iter1 = iter;
-    s.logWeights()(p) += mmh.extend(rng, iter1, last, *s.thetas[p]);
+    s.logWeights()(0) += mmh.extend(rng, iter1, last, *s.thetas[0]);
+
+    /* exceptions cannot leave the parallel region, so are recorded and
+     * rethrown after it */
+    bool degenerated = false, failed = false;
+    int info = 0;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (p = 1; p < s.size(); ++p) {
+      ScheduleIterator iter2 = iter;
+      try {
+        s.logWeights()(p) += mmh.extend(rng, iter2, last, *s.thetas[p]);
+      } catch (CholeskyException e) {
+        #pragma omp critical
+        {
+          info = e.info;
+          failed = true;
+        }
+      } catch (ParticleFilterDegeneratedException e) {
+        #pragma omp critical
+        {
+          degenerated = true;
+          failed = true;
+        }
+      }
+    }
+    if (degenerated) {
+      throw ParticleFilterDegeneratedException();
+    } else if (failed) {
+      throw CholeskyException(info);
+    }
+  } else {
+    for (p = 0; p < s.size(); ++p) {
+      iter1 = iter;
+      s.logWeights()(p) += mmh.extend(rng, iter1, last, *s.thetas[p]);
+    }
   }
   iter = iter1;
 
@@ -265,11 +323,37 @@ template<class S1>
 double bi::MarginalSIR<B,F,A,R>::rejuvenate(Random& rng,
     const ScheduleIterator first, const ScheduleIterator last, S1& s) {
   int p, move, naccept = 0;
-  for (p = 0; p < s.size(); ++p) {
-    for (move = 0; move < Nmoves; ++move) {
-      mmh.propose(rng, first, last, *s.thetas[p], s.theta2);
-      if (mmh.acceptReject(rng, *s.thetas[p], s.theta2)) {
-        ++naccept;
+
+  if (parallel && !S1::on_device) {
+    /* pre-condition */
+    BI_ASSERT(s.theta2s.size() >= bi_omp_max_threads);
+
+    /* times up to last have all been visited, so the caches of inputs and
+     * observations are already filled for them */
+    #pragma omp parallel private(move) reduction(+:naccept)
+    {
+      /* each thread has its own sampler, as this holds the uniform variate
+       * of the current proposal, and its own proposed state */
+      F mmh1(mmh);
+      typename S1::state_type& theta2 = *s.theta2s[bi_omp_tid];
+
+      #pragma omp for schedule(dynamic)
+      for (p = 0; p < s.size(); ++p) {
+        for (move = 0; move < Nmoves; ++move) {
+          mmh1.propose(rng, first, last, *s.thetas[p], theta2);
+          if (mmh1.acceptReject(rng, *s.thetas[p], theta2)) {
+            ++naccept;
+          }
+        }
+      }
+    }
+  } else {
+    for (p = 0; p < s.size(); ++p) {
+      for (move = 0; move < Nmoves; ++move) {
+        mmh.propose(rng, first, last, *s.thetas[p], *s.theta2s[0]);
+        if (mmh.acceptReject(rng, *s.thetas[p], *s.theta2s[0])) {
+          ++naccept;
+        }
       }
     }
   }
@@ -9,6 +9,8 @@
 #define BI_METHOD_SAMPLERFACTORY_HPP
 
 #include "MarginalMH.hpp"
+#include "MarginalMHChains.hpp"
+#include "MarginalDAMH.hpp"
 #include "MarginalSIR.hpp"
 #include "MarginalSRS.hpp"
 
@@ -24,14 +26,28 @@ public:
    * Create marginal Metropolis--Hastings sampler.
    */
   template<class B, class F>
-  static MarginalMH<B,F>* createMarginalMH(B& m, F& filter);
+  static MarginalMH<B,F>* createMarginalMH(B& m, F& filter,
+      const real rho = 0.0);
+
+  /**
+   * Create multiple chains of marginal Metropolis--Hastings sampler.
+   */
+  template<class B, class F>
+  static MarginalMHChains<B,F>* createMarginalMHChains(B& m, F& filter);
+
+  /**
+   * Create marginal delayed-acceptance Metropolis--Hastings sampler.
+   */
+  template<class B, class F, class G>
+  static MarginalDAMH<B,F,G>* createMarginalDAMH(B& m, F& filter,
+      G& surrogate);
 
   /**
    * Create marginal sequential importance resampling sampler.
    */
   template<class B, class F, class A, class R>
   static MarginalSIR<B,F,A,R>* createMarginalSIR(B& m, F& mmh, A& adapter,
-      R& resam, const int Nmoves = 1);
+      R& resam, const int Nmoves = 1, const bool parallel = false);
 
   /**
    * Create marginal sequential rejection sampler.
@@ -43,14 +59,27 @@ public:
 }
 
 template<class B, class F>
-bi::MarginalMH<B,F>* bi::SamplerFactory::createMarginalMH(B& m, F& filter) {
-  return new MarginalMH<B,F>(m, filter);
+bi::MarginalMH<B,F>* bi::SamplerFactory::createMarginalMH(B& m, F& filter,
+    const real rho) {
+  return new MarginalMH<B,F>(m, filter, rho);
+}
+
+template<class B, class F>
+bi::MarginalMHChains<B,F>* bi::SamplerFactory::createMarginalMHChains(B& m,
+    F& filter) {
+  return new MarginalMHChains<B,F>(m, filter);
+}
+
+template<class B, class F, class G>
+bi::MarginalDAMH<B,F,G>* bi::SamplerFactory::createMarginalDAMH(B& m,
+    F& filter, G& surrogate) {
+  return new MarginalDAMH<B,F,G>(m, filter, surrogate);
 }
 
 template<class B, class F, class A, class R>
 bi::MarginalSIR<B,F,A,R>* bi::SamplerFactory::createMarginalSIR(B& m, F& mmh,
-    A& adapter, R& resam, const int Nmoves) {
-  return new MarginalSIR<B,F,A,R>(m, mmh, adapter, resam, Nmoves);
+    A& adapter, R& resam, const int Nmoves, const bool parallel) {
+  return new MarginalSIR<B,F,A,R>(m, mmh, adapter, resam, Nmoves, parallel);
 }
 
 template<class B, class F, class A, class S>
@@ -11,6 +11,9 @@
 #include "../state/Schedule.hpp"
 #include "../cache/SimulatorCache.hpp"
 #include "../state/State.hpp"
+#include "../misc/omp.hpp"
+
+#include <algorithm>
 
 namespace bi {
 /**
@@ -316,6 +319,7 @@ void bi::Simulator<B,F,O>::init(Random& rng, const ScheduleElement now,
 
   /* initial values */
   s.getDyn().clear();
+  s.getStep().clear();
   m.initialSamples(rng, s);
 }
 
@@ -334,14 +338,50 @@ template<class B, class F, class O>
 template<bi::Location L>
 void bi::Simulator<B,F,O>::advance(Random& rng, const ScheduleElement next,
     State<B,L>& s) {
-  if (next.hasInput()) {
-    in.update(next.indexInput(), s);
+  const int start = s.start();
+  const int size = s.size();
+  const int tile = State<B,L>::on_device ? 0 : roundup(bi_omp_tile_size());
+  boost::uint64_t st = 0;
+  int p;
+
+  /* within a persistent team, only the transition is shared */
+  if (bi_omp_serial_begin()) {
+    if (next.hasInput()) {
+      in.update(next.indexInput(), s);
+    }
+    if (next.hasObs()) {
+      obs.update(next.indexObs(), s);
+    }
   }
-  if (next.hasObs()) {
-    obs.update(next.indexObs(), s);
+  bi_omp_serial_end();
+  if (tile > 1 && tile < size) {
+    /* all blocks of the transition over one tile of trajectories before the
+     * next, so that each thread's share of the tile stays in cache from one
+     * block to the next; trajectories are updated independently, so only the
+     * order of blocks within each tile matters. Each tile reuses the streams
+     * of the first, and samplers key substreams by absolute row, so that
+     * variates are the same as without tiling, whatever the tile size */
+    if (bi_omp_serial_begin()) {
+      st = rng.tellHostStream();
+    }
+    bi_omp_serial_end();
+    for (p = 0; p < size; p += tile) {
+      if (bi_omp_serial_begin()) {
+        s.setRange(start + p, std::min(tile, size - p));
+        rng.seekHostStream(st);
+      }
+      bi_omp_serial_end();
+      m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(),
+          s);
+    }
+  } else {
+    m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(), s);
   }
-  m.transitionSamples(rng, next.getFrom(), next.getTo(), next.hasDelta(), s);
-  s.setTime(next.getTime());
+  if (bi_omp_serial_begin()) {
+    s.setRange(start, size);
+    s.setTime(next.getTime());
+  }
+  bi_omp_serial_end();
 }
 
 template<class B, class F, class O>
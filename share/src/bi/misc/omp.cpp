@@ -11,6 +11,13 @@
 
 BI_THREAD int bi_omp_tid;
 int bi_omp_max_threads;
+bool bi_omp_first_touch = false;
+bool bi_omp_huge_pages = false;
+int bi_omp_tile = 0;
+bool bi_omp_persistent = false;
+BI_THREAD bool bi_omp_team = false;
+BI_THREAD int bi_omp_serial = 0;
+BI_THREAD bi_omp_team_state* bi_omp_team_shared = NULL;
 
 #ifdef ENABLE_CUDA
 BI_THREAD cublasHandle_t bi_omp_cublas_handle;
@@ -62,3 +69,93 @@ void bi_omp_term() {
     #endif
   }
 }
+
+void bi_omp_set_persistent(const bool persistent) {
+  bi_omp_persistent = persistent;
+}
+
+void bi_omp_set_first_touch(const bool touch) {
+  bi_omp_first_touch = touch;
+}
+
+void bi_omp_set_huge_pages(const bool huge) {
+  bi_omp_huge_pages = huge;
+}
+
+void bi_omp_set_tile(const int tile) {
+  bi_omp_tile = tile;
+}
+
+int bi_omp_tile_size() {
+  #if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+  if (omp_get_active_level() > 0 && omp_get_num_threads() == 1) {
+    /* one of several filters run concurrently, e.g. chains or
+     * theta-particles; tiles rewind the stream counter of the common
+     * generator, which these share */
+    return 0;
+  }
+  #endif
+  return bi_omp_tile*bi_omp_max_threads;
+}
+
+bool bi_omp_serial_begin() {
+  bool run = true;
+  if (bi_omp_team) {
+    #if defined(ENABLE_OPENMP) and defined(HAVE_OMP_H)
+    run = omp_get_thread_num() == 0;
+    #endif
+    if (run) {
+      bi_omp_team = false;
+      bi_omp_serial = 1;
+    }
+  } else if (bi_omp_serial > 0) {
+    ++bi_omp_serial;
+  }
+  return run;
+}
+
+void bi_omp_serial_end() {
+  if (bi_omp_serial > 0) {
+    --bi_omp_serial;
+    bi_omp_team = bi_omp_serial == 0;
+  }
+  if (bi_omp_team) {
+    #pragma omp barrier
+  }
+}
+
+bool bi_omp_serial_end(const bool failed, int& info) {
+  bool result = failed;
+  if (bi_omp_serial > 0) {
+    --bi_omp_serial;
+    bi_omp_team = bi_omp_serial == 0;
+    if (bi_omp_team && failed) {
+      bi_omp_team_shared->failed = true;
+      bi_omp_team_shared->info = info;
+    }
+  }
+  if (bi_omp_team) {
+    #pragma omp barrier
+    result = bi_omp_team_shared->failed;
+    if (result) {
+      info = bi_omp_team_shared->info;
+    }
+    #pragma omp barrier
+    #pragma omp master
+    {
+      bi_omp_team_shared->failed = false;
+      bi_omp_team_shared->info = 0;
+    }
+  }
+  return result;
+}
+
+void bi_omp_team_begin(bi_omp_team_state& state) {
+  bi_omp_team_shared = &state;
+  bi_omp_team = true;
+}
+
+void bi_omp_team_end() {
+  bi_omp_team = false;
+  bi_omp_team_shared = NULL;
+}
@@ -30,6 +30,64 @@ extern BI_THREAD int bi_omp_tid;
  */
 extern int bi_omp_max_threads;
 
+/**
+ * Run each filter step within one persistent team of threads?
+ */
+extern bool bi_omp_persistent;
+
+/**
+ * Place state storage by first touch from the threads that update it?
+ */
+extern bool bi_omp_first_touch;
+
+/**
+ * Back large host allocations with huge pages?
+ */
+extern bool bi_omp_huge_pages;
+
+/**
+ * Number of trajectories per thread in each tile of a tiled transition,
+ * zero if transitions are not tiled.
+ */
+extern int bi_omp_tile;
+
+/**
+ * Is the thread one of a persistent team? If so, updaters that support it
+ * share their work with the rest of the team via orphaned worksharing
+ * constructs, rather than forking a team of their own.
+ */
+extern BI_THREAD bool bi_omp_team;
+
+/**
+ * Depth of nested serial sections of a persistent team on the thread.
+ */
+extern BI_THREAD int bi_omp_serial;
+
+/**
+ * State shared by the threads of one persistent team, through which the
+ * thread that runs a serial section reports its failure to the rest.
+ */
+struct bi_omp_team_state {
+  bi_omp_team_state() : failed(false), info(0) {
+    //
+  }
+
+  /**
+   * Did the last serial section fail?
+   */
+  bool failed;
+
+  /**
+   * Error code of the failure.
+   */
+  int info;
+};
+
+/**
+ * State of the persistent team of the thread, NULL if none.
+ */
+extern BI_THREAD bi_omp_team_state* bi_omp_team_shared;
+
 #ifdef ENABLE_CUDA
 /**
  * CUBLAS context handle for CUBLAS function calls (API v2).
@@ -45,6 +103,8 @@ extern BI_THREAD cudaStream_t bi_omp_cuda_stream;
 
 #ifdef __ICC
 #pragma omp threadprivate(bi_omp_tid)
+#pragma omp threadprivate(bi_omp_team)
+#pragma omp threadprivate(bi_omp_serial)
 #ifdef ENABLE_CUDA
 #pragma omp threadprivate(bi_omp_cublas_handle)
 #pragma omp threadprivate(bi_omp_cuda_stream)
@@ -63,4 +123,93 @@ void bi_omp_init(const int threads = 0);
  */
 void bi_omp_term();
 
+/**
+ * Enable or disable persistent teams for filter steps.
+ *
+ * @param persistent True to enable, false to disable.
+ */
+void bi_omp_set_persistent(const bool persistent);
+
+/**
+ * Enable or disable NUMA-aware placement of state storage. When enabled,
+ * each thread first touches the storage of those trajectories that it
+ * updates, so that the operating system places it on the thread's own
+ * NUMA node. Threads should be bound to cores, e.g. with
+ * <tt>OMP_PROC_BIND=true</tt>, for placement to persist.
+ *
+ * @param touch True to enable, false to disable.
+ */
+void bi_omp_set_first_touch(const bool touch);
+
+/**
+ * Enable or disable huge pages for large host allocations, where the
+ * operating system supports them.
+ *
+ * @param huge True to enable, false to disable.
+ */
+void bi_omp_set_huge_pages(const bool huge);
+
+/**
+ * Set tile size for tiled transitions.
+ *
+ * @param tile Number of trajectories per thread in each tile, zero to
+ * disable tiling.
+ */
+void bi_omp_set_tile(const int tile);
+
+/**
+ * Get tile size for tiled transitions.
+ *
+ * @return Total number of trajectories in each tile, across all threads,
+ * zero if transitions are not tiled. Transitions are not tiled by a thread
+ * that is alone in its team within an active parallel region, as several
+ * filters may then be running concurrently.
+ */
+int bi_omp_tile_size();
+
+/**
+ * Begin serial section. Within a persistent team, only the master thread
+ * runs the section, as an ordinary thread outside of the team. Outside of a
+ * persistent team, the calling thread runs it.
+ *
+ * @return True if the calling thread should run the section.
+ *
+ * Every call must be matched by a call to bi_omp_serial_end() on all
+ * threads, whether or not they run the section.
+ */
+bool bi_omp_serial_begin();
+
+/**
+ * End serial section. Within a persistent team, this is a barrier.
+ */
+void bi_omp_serial_end();
+
+/**
+ * End serial section that may have failed. Within a persistent team, this
+ * is a barrier, after which all threads see the result of the thread that
+ * ran the section, so that they can leave it together, e.g. by throwing
+ * the same exception.
+ *
+ * @param failed Did the section fail? Ignored on threads that did not run
+ * it.
+ * @param[in,out] info Error code of the failure. On threads that did not
+ * run the section, set to that of the thread that did.
+ *
+ * @return Did the section fail?
+ */
+bool bi_omp_serial_end(const bool failed, int& info);
+
+/**
+ * Join a persistent team. To be called by every thread of a parallel
+ * region, which then acts as the team until bi_omp_team_end().
+ *
+ * @param state State of the team, shared by all of its threads.
+ */
+void bi_omp_team_begin(bi_omp_team_state& state);
+
+/**
+ * Leave a persistent team.
+ */
+void bi_omp_team_end();
+
 #endif
@@ -47,6 +47,21 @@ public:
   bool isTriggered(const V1 lws) const
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * @copydoc Resampler::isTriggered(const double, const int) const
+   */
+  bool isTriggered(const double ess, const int P) const;
+
+  /**
+   * @copydoc Resampler::reduce
+   *
+   * The ESS is that across all processes, while the log of the sum of
+   * weights is that of this process alone, as used for normalise().
+   */
+  template<class V1>
+  static void reduce(const V1 lws, double& lW, double& ess)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc Resampler::ess
    */
@@ -204,35 +219,47 @@ bool bi::DistributedResampler<R>::isTriggered(const V1 lws) const
   return essRel >= 1.0 || ess(lws) < essRel * size * P;
 }
 
+template<class R>
+bool bi::DistributedResampler<R>::isTriggered(const double ess,
+    const int P) const {
+  boost::mpi::communicator world;
+  const int size = world.size();
+
+  return essRel >= 1.0 || ess < essRel * size * P;
+}
+
 template<class R>
 template<class V1>
-typename V1::value_type bi::DistributedResampler<R>::ess(const V1 lws)
-    throw (ParticleFilterDegeneratedException) {
+void bi::DistributedResampler<R>::reduce(const V1 lws, double& lW,
+    double& ess) throw (ParticleFilterDegeneratedException) {
   typedef typename V1::value_type T1;
 
-  T1 mx, sum1, sum2, result;
+  T1 mx, sum1, sum2, gmx, z;
   boost::mpi::communicator world;
 
-  mx = max_reduce(lws);
-  mx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<T1>());
+  max_sumexp_reduce(lws, mx, sum1, sum2);
+  lW = mx + bi::log(static_cast<double>(sum1));
 
-  sum1 = op_reduce(lws, nan_minus_and_exp_functor<T1>(mx), 0.0,
-      thrust::plus<T1>());
-  sum1 = boost::mpi::all_reduce(world, sum1, std::plus<T1>());
+  gmx = boost::mpi::all_reduce(world, mx, boost::mpi::maximum<T1>());
+  z = (sum1 > 0.0) ? bi::exp(mx - gmx) : 0.0;
+  sum1 = boost::mpi::all_reduce(world, sum1*z, std::plus<T1>());
+  sum2 = boost::mpi::all_reduce(world, sum2*z*z, std::plus<T1>());
 
-  sum2 = op_reduce(lws, nan_minus_exp_and_square_functor<T1>(mx), 0.0,
-      thrust::plus<T1>());
-  sum2 = boost::mpi::all_reduce(world, sum2, std::plus<T1>());
-
-  result = (sum1 * sum1) / sum2;
-
-  if (result > 0.0) {
-    return result;
-  } else {
+  ess = static_cast<double>(sum1)*sum1/sum2;
+  if (!(ess > 0.0)) {
     throw ParticleFilterDegeneratedException();
   }
 }
 
+template<class R>
+template<class V1>
+typename V1::value_type bi::DistributedResampler<R>::ess(const V1 lws)
+    throw (ParticleFilterDegeneratedException) {
+  double lW, ess;
+  reduce(lws, lW, ess);
+  return ess;
+}
+
 template<class R>
 template<class M1, class O1>
 void bi::DistributedResampler<R>::redistribute(M1 O, O1& s) {
@@ -16,6 +16,9 @@ namespace bi {
  * Update using Dormand-Prince 5(4) integrator with adaptive step-size
  * control.
  *
+ * Dense output (see h_ode_set_dense()) is supported on host only, and
+ * selects the host implementation over the SSE implementation.
+ *
  * @ingroup method_updater
  *
  * @tparam B Model type.
@@ -38,6 +41,7 @@ public:
 #include "../host/ode/DOPRI5IntegratorHost.hpp"
 #ifdef ENABLE_SSE
 #include "../sse/ode/DOPRI5IntegratorSSE.hpp"
+#include "../sse/ode/DOPRI5LaneIntegratorSSE.hpp"
 #endif
 #ifdef __CUDACC__
 #include "../cuda/ode/DOPRI5IntegratorGPU.cuh"
@@ -52,8 +56,12 @@ void bi::DOPRI5Integrator<B,S>::update(const T1 t1, const T1 t2,
 
   if (bi::abs(t2 - t1) > 0.0) {
     #ifdef ENABLE_SSE
-    if (s.size() % BI_SIMD_SIZE == 0) {
+    if (s.size() % BI_SIMD_SIZE == 0 && !h_dense) {
+      #ifdef ENABLE_SSE_LANES
+      DOPRI5LaneIntegratorSSE<B,S,T1>::update(t1, t2, s);
+      #else
       DOPRI5IntegratorSSE<B,S,T1>::update(t1, t2, s);
+      #endif
     } else {
       DOPRI5IntegratorHost<B,S,T1>::update(t1, t2, s);
     }
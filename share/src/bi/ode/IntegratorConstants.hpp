@@ -30,6 +30,22 @@ void bi_ode_init();
  */
 void bi_ode_set(const real h0, const real atoler, const real rtoler);
 
+/**
+ * Set scheduling of trajectories across threads.
+ *
+ * @param chunk Number of trajectories per chunk for dynamic scheduling, zero
+ * for static scheduling.
+ */
+void bi_ode_set_chunk(const int chunk);
+
+/**
+ * Enable or disable dense output for adaptive ODE integrators that support
+ * it.
+ *
+ * @param dense True to enable, false to disable.
+ */
+void bi_ode_set_dense(const bool dense);
+
 inline void bi_ode_init() {
   #ifdef __CUDACC__
   ode_init();
@@ -58,4 +74,12 @@ inline void bi_ode_set(const real h0, const real atoler, const real rtoler) {
   }
 }
 
+inline void bi_ode_set_chunk(const int chunk) {
+  h_ode_set_chunk(chunk);
+}
+
+inline void bi_ode_set_dense(const bool dense) {
+  h_ode_set_dense(dense);
+}
+
 #endif
@@ -38,6 +38,7 @@ public:
 #include "../host/ode/RK43IntegratorHost.hpp"
 #ifdef ENABLE_SSE
 #include "../sse/ode/RK43IntegratorSSE.hpp"
+#include "../sse/ode/RK43LaneIntegratorSSE.hpp"
 #endif
 #ifdef __CUDACC__
 #include "../cuda/ode/RK43IntegratorGPU.cuh"
@@ -53,7 +54,11 @@ void bi::RK43Integrator<B,S>::update(const T1 t1, const T1 t2,
   if (bi::abs(t2 - t1) > 0.0) {
     #ifdef ENABLE_SSE
     if (s.size() % BI_SIMD_SIZE == 0) {
+      #ifdef ENABLE_SSE_LANES
+      RK43LaneIntegratorSSE<B,S,T1>::update(t1, t2, s);
+      #else
       RK43IntegratorSSE<B,S,T1>::update(t1, t2, s);
+      #endif
     } else {
       RK43IntegratorHost<B,S,T1>::update(t1, t2, s);
     }
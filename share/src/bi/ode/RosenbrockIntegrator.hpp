@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROSENBROCKINTEGRATOR_HPP
+#define BI_ODE_ROSENBROCKINTEGRATOR_HPP
+
+#include "../misc/location.hpp"
+#include "../state/State.hpp"
+
+namespace bi {
+/**
+ * Update using linearly implicit Rosenbrock integrator with adaptive
+ * step-size control, for stiff systems.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ * @tparam X Block type, providing jacobian().
+ *
+ * The block type @p X must provide a static member function
+ *
+ * @code
+ * template<class T1, Location L, class PX, class T2>
+ * static void jacobian(const T1 t, const State<B,L>& s, const int p,
+ *     const PX& pax, T2* J);
+ * @endcode
+ *
+ * that adds the Jacobian of the time derivatives of the targets of @p S,
+ * with respect to those same targets, into the column-major matrix @p J.
+ * This is generated from the symbolic derivatives of the ode block.
+ */
+template<class B, class S, class X>
+class RosenbrockIntegrator {
+public:
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+  #ifdef __CUDACC__
+  template<class T1>
+  static void update(const T1 t1, const T1 t2, State<B,ON_DEVICE>& s);
+  #endif
+};
+
+}
+
+#include "../host/ode/RosenbrockIntegratorHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/ode/RosenbrockIntegratorSSE.hpp"
+#endif
+
+template<class B, class S, class X>
+template<class T1>
+void bi::RosenbrockIntegrator<B,S,X>::update(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
+  /* pre-conditions */
+  BI_ASSERT(t1 <= t2);
+
+  if (bi::abs(t2 - t1) > 0.0) {
+    #ifdef ENABLE_SSE
+    if (s.size() % BI_SIMD_SIZE == 0) {
+      RosenbrockIntegratorSSE<B,S,X,T1>::update(t1, t2, s);
+    } else {
+      RosenbrockIntegratorHost<B,S,X,T1>::update(t1, t2, s);
+    }
+    #else
+    RosenbrockIntegratorHost<B,S,X,T1>::update(t1, t2, s);
+    #endif
+  }
+}
+
+#ifdef __CUDACC__
+template<class B, class S, class X>
+template<class T1>
+void bi::RosenbrockIntegrator<B,S,X>::update(const T1 t1, const T1 t2,
+    State<B,ON_DEVICE>& s) {
+  /* pre-conditions */
+  BI_ASSERT(t1 <= t2);
+
+  BI_ERROR_MSG(false, "Rosenbrock integrator is not supported on device");
+}
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_ODE_ROSENBROCKSTAGE_HPP
+#define BI_ODE_ROSENBROCKSTAGE_HPP
+
+#include "../cuda/cuda.hpp"
+
+namespace bi {
+/**
+ * Stage calculations for RosenbrockIntegrator.
+ *
+ * @tparam T1 Scalar type.
+ * @tparam T2 Scalar type.
+ *
+ * Stages are in the form of @ref Sandu1997 "Sandu et al. (1997)", where
+ * each stage solves \f$(I/(\gamma h) - J)k_i = f(t + \alpha_i h, x_0 +
+ * \sum_{j<i} a_{ij}k_j) + \sum_{j<i} (c_{ij}/h)k_j\f$, with @p k_i already
+ * scaled by the step size. The second and third stages share one evaluation
+ * of the time derivatives.
+ */
+template<class T1, class T2>
+class RosenbrockStage {
+public:
+  /**
+   * Shift applied to the diagonal of the iteration matrix.
+   */
+  static CUDA_FUNC_BOTH T1 shift(const T1 h) {
+    const real gamma = BI_REAL(0.43586652150845899941601945119356);
+
+    return BI_REAL(1.0)/(gamma*h);
+  }
+
+  /**
+   * Time at which derivatives are evaluated for stages 2 and 3.
+   */
+  static CUDA_FUNC_BOTH T1 time2(const T1 t, const T1 h) {
+    const real alpha2 = BI_REAL(0.43586652150845899941601945119356);
+
+    return t + alpha2*h;
+  }
+
+  static CUDA_FUNC_BOTH void stage1(const T2 x0, const T2 k1, T2& x1) {
+    const real a21 = BI_REAL(1.0);
+
+    x1 = x0 + a21*k1;
+  }
+
+  static CUDA_FUNC_BOTH void stage2(const T1 h, const T2 f, const T2 k1,
+      T2& k2) {
+    const real c21 = BI_REAL(-0.10156171083877702091975600115545E+01);
+
+    k2 = f + (c21/h)*k1;
+  }
+
+  static CUDA_FUNC_BOTH void stage3(const T1 h, const T2 f, const T2 k1,
+      const T2 k2, T2& k3) {
+    const real c31 = BI_REAL(0.40759956452537699824805835358067E+01);
+    const real c32 = BI_REAL(0.92076794298330791242156818474003E+01);
+
+    k3 = f + (c31*k1 + c32*k2)/h;
+  }
+
+  static CUDA_FUNC_BOTH void stageErr(const T2 x0, const T2 k1, const T2 k2,
+      const T2 k3, T2& x1, T2& err) {
+    const real m1 = BI_REAL(0.1E+01);
+    const real m2 = BI_REAL(0.61697947043828245592553615689730E+01);
+    const real m3 = BI_REAL(-0.42772256543218573326238373806514E+00);
+    const real e1 = BI_REAL(0.5E+00);
+    const real e2 = BI_REAL(-0.29079558716805469821718236208017E+01);
+    const real e3 = BI_REAL(0.22354069897811569627360909276199E+00);
+
+    x1 = x0 + m1*k1 + m2*k2 + m3*k3;
+    err = e1*k1 + e2*k2 + e3*k3;
+  }
+};
+
+}
+
+#endif
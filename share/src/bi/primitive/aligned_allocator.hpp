@@ -8,7 +8,10 @@
 #ifndef BI_MISC_ALIGNED_ALLOCATOR_HPP
 #define BI_MISC_ALIGNED_ALLOCATOR_HPP
 
+#include "../misc/omp.hpp"
+
 #include <cstdlib>
+#include <sys/mman.h>
 
 namespace bi {
 /**
@@ -56,7 +59,21 @@ public:
 
   pointer allocate(size_type num, const_pointer *hint = 0) {
     pointer ptr;
-    int err = posix_memalign((void**)&ptr, X, num*sizeof(T));
+    int err;
+    #ifdef MADV_HUGEPAGE
+    /* huge page size assumed to be 2MB, as on x86-64 */
+    static const size_t huge = 2*1024*1024;
+    if (bi_omp_huge_pages && num*sizeof(T) >= huge) {
+      err = posix_memalign((void**)&ptr, huge, num*sizeof(T));
+      if (err == 0) {
+        madvise(ptr, num*sizeof(T), MADV_HUGEPAGE);  // advisory only
+      }
+    } else {
+      err = posix_memalign((void**)&ptr, X, num*sizeof(T));
+    }
+    #else
+    err = posix_memalign((void**)&ptr, X, num*sizeof(T));
+    #endif
     BI_ERROR_MSG(err == 0, "Aligned memory allocation failed");
     return ptr;
   }
@@ -0,0 +1,337 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_MISC_ARENA_ALLOCATOR_HPP
+#define BI_MISC_ARENA_ALLOCATOR_HPP
+
+#include "../misc/omp.hpp"
+#include "../misc/assert.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace bi {
+/**
+ * Wraps another allocator to provide thread-local arenas of reusable
+ * allocations, in power-of-two size classes.
+ *
+ * @tparam A Other allocator type. Must allocate host memory.
+ *
+ * @ingroup primitive_allocators
+ *
+ * Each thread keeps one free list per size class. Free lists are intrusive:
+ * the link to the next free buffer is stored in the buffer itself, so that
+ * neither allocation nor deallocation allocates any memory of its own, and
+ * finding the list for a size is an index rather than a map search. A buffer
+ * is returned to the free list of the thread that deallocates it, which
+ * then owns it.
+ *
+ * Allocations are rounded up to the next size class, so that a buffer may be
+ * reused for any size in its class. Allocations larger than the largest size
+ * class are not pooled.
+ *
+ * This class is thread safe, and does not lock once the arenas are set up.
+ * Unlike pooled_allocator, it cannot be used for device memory.
+ */
+template<class A>
+class arena_allocator {
+public:
+  typedef typename A::size_type size_type;
+  typedef typename A::difference_type difference_type;
+  typedef typename A::pointer pointer;
+  typedef typename A::const_pointer const_pointer;
+  typedef typename A::reference reference;
+  typedef typename A::const_reference const_reference;
+  typedef typename A::value_type value_type;
+
+  template <class U>
+  struct rebind {
+    typedef arena_allocator<typename A::template rebind<U>::other> other;
+  };
+
+  arena_allocator() {
+    //
+  }
+
+  arena_allocator(const arena_allocator<A>& o) {
+    //
+  }
+
+  pointer address(reference value) const;
+
+  const_pointer address(const_reference value) const;
+
+  size_type max_size() const;
+
+  /**
+   * Allocate new item, drawing from the free list of its size class if
+   * possible.
+   */
+  pointer allocate(size_type num, const_pointer *hint = 0);
+
+  void construct(pointer p, const value_type& t);
+
+  void destroy(pointer p);
+
+  /**
+   * Return item to the free list of its size class for the calling thread.
+   */
+  void deallocate(pointer p, size_type num);
+
+  bool operator==(const arena_allocator<A>& o) const {
+    return true;
+  }
+
+  template<class U>
+  bool operator==(const arena_allocator<U>& o) const {
+    return false;
+  }
+
+  bool operator!=(const arena_allocator<A>& o) const {
+    return false;
+  }
+
+  template<class U>
+  bool operator!=(const arena_allocator<U>& o) const {
+    return true;
+  }
+
+  /**
+   * Empty free lists of the calling thread.
+   */
+  void empty();
+
+  /**
+   * Get allocation counters, summed over all threads. Call outside of
+   * parallel regions only.
+   *
+   * @param[out] allocs Number of allocations.
+   * @param[out] reuses Number of allocations drawn from a free list.
+   * @param[out] frees Number of deallocations.
+   */
+  static void counts(long& allocs, long& reuses, long& frees);
+
+private:
+  /**
+   * Number of size classes. Size class @c k holds buffers of
+   * <tt>2^k</tt> bytes, so that the largest holds buffers of 1GB.
+   */
+  static const int NCLASSES = 31;
+
+  /**
+   * Arena of one thread.
+   */
+  struct arena {
+    /**
+     * Heads of free lists, one for each size class.
+     */
+    pointer heads[NCLASSES];
+
+    /*
+     * Counters.
+     */
+    long allocs, reuses, frees;
+
+    /**
+     * Padding, so that arenas of different threads do not share cache
+     * lines.
+     */
+    char pad[64];
+  };
+
+  /**
+   * Size class of allocation.
+   *
+   * @param num Number of items.
+   *
+   * @return Size class, or -1 if too large to pool.
+   */
+  static int sizeClass(const size_type num);
+
+  /**
+   * Number of items in buffers of size class.
+   *
+   * @param k Size class.
+   */
+  static size_type classSize(const int k);
+
+  /**
+   * Link to next buffer in free list.
+   */
+  static pointer& next(pointer p);
+
+  /**
+   * Set up arenas, if necessary.
+   */
+  static void init();
+
+  /**
+   * Wrapped allocator.
+   */
+  A alloc;
+
+  /**
+   * Arenas, indexed by thread.
+   */
+  static std::vector<arena> arenas;
+};
+
+}
+
+template<class A>
+std::vector<typename bi::arena_allocator<A>::arena>
+    bi::arena_allocator<A>::arenas;
+
+template<class A>
+inline typename bi::arena_allocator<A>::pointer
+    bi::arena_allocator<A>::address(reference value) const {
+  return alloc.address(value);
+}
+
+template<class A>
+inline typename bi::arena_allocator<A>::const_pointer
+    bi::arena_allocator<A>::address(const_reference value) const {
+  return alloc.address(value);
+}
+
+template<class A>
+inline typename bi::arena_allocator<A>::size_type
+    bi::arena_allocator<A>::max_size() const {
+  return alloc.max_size();
+}
+
+template<class A>
+inline typename bi::arena_allocator<A>::pointer
+    bi::arena_allocator<A>::allocate(size_type num, const_pointer *hint) {
+  pointer p = NULL;
+  if (num > 0) {
+    init();
+
+    arena& a = arenas[bi_omp_tid];
+    const int k = sizeClass(num);
+    ++a.allocs;
+    if (k < 0) {
+      /* too large to pool */
+      p = alloc.allocate(num, hint);
+    } else if (a.heads[k] != NULL) {
+      /* reuse */
+      p = a.heads[k];
+      a.heads[k] = next(p);
+      ++a.reuses;
+    } else {
+      /* new, rounded up to size class */
+      p = alloc.allocate(classSize(k), hint);
+    }
+  }
+  return p;
+}
+
+template<class A>
+inline void bi::arena_allocator<A>::construct(pointer p,
+    const value_type& t) {
+  alloc.construct(p, t);
+}
+
+template<class A>
+inline void bi::arena_allocator<A>::destroy(pointer p) {
+  alloc.destroy(p);
+}
+
+template<class A>
+inline void bi::arena_allocator<A>::deallocate(pointer p, size_type num) {
+  if (p != NULL) {
+    init();
+
+    arena& a = arenas[bi_omp_tid];
+    const int k = sizeClass(num);
+    ++a.frees;
+    if (k < 0) {
+      alloc.deallocate(p, num);
+    } else {
+      next(p) = a.heads[k];
+      a.heads[k] = p;
+    }
+  }
+}
+
+template<class A>
+void bi::arena_allocator<A>::empty() {
+  if (bi_omp_tid < (int)arenas.size()) {
+    arena& a = arenas[bi_omp_tid];
+    pointer p;
+    int k;
+    for (k = 0; k < NCLASSES; ++k) {
+      while (a.heads[k] != NULL) {
+        p = a.heads[k];
+        a.heads[k] = next(p);
+        alloc.deallocate(p, classSize(k));
+      }
+    }
+  }
+}
+
+template<class A>
+void bi::arena_allocator<A>::counts(long& allocs, long& reuses,
+    long& frees) {
+  allocs = 0;
+  reuses = 0;
+  frees = 0;
+  for (int i = 0; i < (int)arenas.size(); ++i) {
+    allocs += arenas[i].allocs;
+    reuses += arenas[i].reuses;
+    frees += arenas[i].frees;
+  }
+}
+
+template<class A>
+inline int bi::arena_allocator<A>::sizeClass(const size_type num) {
+  /* smallest class must hold link to next buffer */
+  size_type bytes = num*sizeof(value_type);
+  if (bytes < sizeof(pointer)) {
+    bytes = sizeof(pointer);
+  }
+
+  int k = 0;
+  while (k < NCLASSES && (size_type(1) << k) < bytes) {
+    ++k;
+  }
+  return (k < NCLASSES) ? k : -1;
+}
+
+template<class A>
+inline typename bi::arena_allocator<A>::size_type
+    bi::arena_allocator<A>::classSize(const int k) {
+  return ((size_type(1) << k) + sizeof(value_type) - 1)/sizeof(value_type);
+}
+
+template<class A>
+inline typename bi::arena_allocator<A>::pointer&
+    bi::arena_allocator<A>::next(pointer p) {
+  return *reinterpret_cast<pointer*>(p);
+}
+
+template<class A>
+inline void bi::arena_allocator<A>::init() {
+  if (bi_omp_max_threads > (int)arenas.size()) {
+    /* this outer conditional avoids the critical section most the time, but
+     * multiple threads may get this far */
+    #pragma omp critical
+    {
+      if (bi_omp_max_threads > (int)arenas.size()) {
+        /* only one thread gets this far */
+        arena a;
+        std::fill(a.heads, a.heads + NCLASSES, pointer(NULL));
+        a.allocs = 0;
+        a.reuses = 0;
+        a.frees = 0;
+        arenas.resize(bi_omp_max_threads, a);
+      }
+    }
+  }
+}
+
+#endif
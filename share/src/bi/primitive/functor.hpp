@@ -14,6 +14,8 @@
 #include "../math/misc.hpp"
 #include "../cuda/cuda.hpp"
 
+#include "thrust/tuple.h"
+
 namespace bi {
 /**
  * @ingroup primitive_functor
@@ -656,6 +658,53 @@ struct ess_functor : public std::binary_function<std::pair<T,T>,std::pair<T,T>,s
   }
 };
 
+/**
+ * @ingroup primitive_functor
+ *
+ * Unary functor giving the maximum, sum-exp and sum-exp-square of a single
+ * element, as a tuple. NaN and zero weights give an empty tuple.
+ */
+template<class T>
+struct nan_max_sumexp_functor : public std::unary_function<T,
+    thrust::tuple<T,T,T> > {
+  CUDA_FUNC_BOTH thrust::tuple<T,T,T> operator()(const T& x) const {
+    const T lowest = bi::log(static_cast<T>(0.0));
+    if (!(x > lowest)) {
+      return thrust::make_tuple(lowest,
+          static_cast<T>(0.0), static_cast<T>(0.0));
+    } else {
+      return thrust::make_tuple(x, static_cast<T>(1.0),
+          static_cast<T>(1.0));
+    }
+  }
+};
+
+/**
+ * @ingroup primitive_functor
+ *
+ * Combines two maximum, sum-exp and sum-exp-square tuples, rescaling the
+ * sums to the larger of the two maxima.
+ */
+template<class T>
+struct max_sumexp_functor : public std::binary_function<
+    thrust::tuple<T,T,T>,thrust::tuple<T,T,T>,thrust::tuple<T,T,T> > {
+  CUDA_FUNC_BOTH thrust::tuple<T,T,T> operator()(
+      const thrust::tuple<T,T,T>& x, const thrust::tuple<T,T,T>& y) const {
+    const T mx = bi::max(thrust::get<0>(x), thrust::get<0>(y));
+    T zx = 0.0, zy = 0.0;
+
+    if (thrust::get<1>(x) > 0.0) {
+      zx = bi::exp(thrust::get<0>(x) - mx);
+    }
+    if (thrust::get<1>(y) > 0.0) {
+      zy = bi::exp(thrust::get<0>(y) - mx);
+    }
+    return thrust::make_tuple(mx,
+        thrust::get<1>(x)*zx + thrust::get<1>(y)*zy,
+        thrust::get<2>(x)*zx*zx + thrust::get<2>(y)*zy*zy);
+  }
+};
+
 }
 
 #endif
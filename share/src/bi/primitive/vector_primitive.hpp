@@ -15,6 +15,7 @@
 #define BI_PRIMITIVE_VECTORPRIMITIVE_HPP
 
 #include "functor.hpp"
+#include "../misc/location.hpp"
 
 #include "thrust/functional.h"
 
@@ -180,6 +181,38 @@ typename V1::value_type logsumexp_reduce(const V1 x);
 template<class V1>
 typename V1::value_type sumexpsq_reduce(const V1 x);
 
+/**
+ * Fused maximum, sum-exp and sum-exp-square reduction.
+ *
+ * @ingroup primitive_vector
+ *
+ * @tparam V1 Vector type.
+ *
+ * @param x The vector.
+ * @param[out] mx \f$y = \max(\mathbf{x})\f$.
+ * @param[out] sum1 \f$\sum_i \exp(x_i - y)\f$.
+ * @param[out] sum2 \f$\sum_i \exp(2(x_i - y))\f$.
+ *
+ * Unlike sumexp_reduce() and sumexpsq_reduce(), which first find the
+ * maximum then make a second pass, this makes a single pass over the input
+ * sequence. Partial sums are rescaled whenever a larger maximum is found,
+ * which is rare after the first few elements. NaN values do not contribute
+ * to the sums.
+ */
+template<class V1>
+void max_sumexp_reduce(const V1 x, typename V1::value_type& mx,
+    typename V1::value_type& sum1, typename V1::value_type& sum2);
+
+/**
+ * @internal
+ */
+template<Location L>
+struct max_sumexp_reduce_impl {
+  template<class V1>
+  static void func(const V1 x, typename V1::value_type& mx,
+      typename V1::value_type& sum1, typename V1::value_type& sum2);
+};
+
 /**
  * Compute effective sample size.
  *
@@ -784,6 +817,10 @@ bool equal(const V1 input1, const V1 input2);
 }
 
 #include "../math/sim_temp_vector.hpp"
+#include "../host/primitive/vector_primitive.hpp"
+#ifdef __CUDACC__
+#include "../cuda/primitive/vector_primitive.cuh"
+#endif
 
 #include "thrust/extrema.h"
 #include "thrust/transform_reduce.h"
@@ -957,6 +994,12 @@ inline typename V1::value_type bi::sumexpsq_reduce(const V1 x) {
   return result;
 }
 
+template<class V1>
+inline void bi::max_sumexp_reduce(const V1 x, typename V1::value_type& mx,
+    typename V1::value_type& sum1, typename V1::value_type& sum2) {
+  max_sumexp_reduce_impl<V1::location>::func(x, mx, sum1, sum2);
+}
+
 template<class V1>
 typename V1::value_type bi::ess_reduce(const V1 lws) {
   /* pre-condition */
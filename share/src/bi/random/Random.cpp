@@ -13,15 +13,21 @@
 
 bi::Random::Random() : own(true) {
   hostRngs = new RngHost[bi_omp_max_threads];
+  hostCommonRng = new RngHost();
+  hostCommonStream = new boost::uint64_t(0);
 }
 
 bi::Random::Random(const unsigned seed) : own(true) {
   hostRngs = new RngHost[bi_omp_max_threads];
+  hostCommonRng = new RngHost();
+  hostCommonStream = new boost::uint64_t(0);
   this->seeds(seed);
 }
 
 bi::Random::Random(const Random& o) {
   hostRngs = o.hostRngs;
+  hostCommonRng = o.hostCommonRng;
+  hostCommonStream = o.hostCommonStream;
   #ifdef ENABLE_CUDA
   devRngs = o.devRngs;
   #endif
@@ -31,6 +37,8 @@ bi::Random::Random(const Random& o) {
 bi::Random::~Random() {
   if (own) {
     delete[] hostRngs;
+    delete hostCommonRng;
+    delete hostCommonStream;
   }
 }
 
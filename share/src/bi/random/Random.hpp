@@ -9,6 +9,7 @@
 #define BI_RANDOM_RANDOM_HPP
 
 #include "../host/random/RngHost.hpp"
+#include "ReplayStream.hpp"
 #include "../misc/assert.hpp"
 #include "../misc/location.hpp"
 #include "../cuda/cuda.hpp"
@@ -42,6 +43,23 @@ namespace bi {
  * variable before it is copied back to global memory with #setDevRng.
  *
  * Internally, the plural methods take this approach.
+ *
+ * On host, the plural methods instead fork an independent stream of a
+ * common counter-based generator for each element, via #nextHostStream and
+ * #getHostStream, and fill vectors in parallel. The variates are then the
+ * same for any number of threads. When SSE is enabled, #uniforms,
+ * #gaussians, #gammas and #betas are vectorised, see RandomSSE.
+ *
+ * Variates on host may be drawn from a ReplayStream instead, between
+ * #startReplay and #stopReplay. Each replay restarts the streams of bulk
+ * operations from the same number, so that a computation that draws its
+ * variates in the same order reaches the same counters each time.
+ * Singular methods then draw from a stream of their own too, rather than
+ * from the generator of the current thread. Each such draw reserves a
+ * stream in a critical section, so is neither fast nor, within a parallel
+ * loop, in the same order each time; computations that draw singular
+ * variates within parallel loops, such as MetropolisResamplerHost, should
+ * not be replayed.
  */
 class Random {
 public:
@@ -162,7 +180,8 @@ public:
    * @param seed Seed value.
    *
    * All random number generators are seeded differently using a function of
-   * @p seed.
+   * @p seed. On host, the variates of the plural methods depend on @p seed
+   * and the sequence of calls only, not on the number of threads.
    */
   void seeds(const unsigned seed);
 
@@ -249,6 +268,59 @@ public:
    */
   RngHost& getHostRng();
 
+  /**
+   * Reserve a stream number of the common host random number generator,
+   * for one bulk operation.
+   *
+   * @return Stream number.
+   */
+  boost::uint64_t nextHostStream();
+
+  /**
+   * Get a host random number generator for one element of a bulk
+   * operation.
+   *
+   * @param s Stream number, from #nextHostStream.
+   * @param j Element index.
+   *
+   * @return Copy of the common host random number generator, set to the
+   * substream @p j of stream @p s.
+   */
+  RngHost getHostStream(const boost::uint64_t s, const int j) const;
+
+  /**
+   * Get the stream number that #nextHostStream will reserve next.
+   */
+  boost::uint64_t tellHostStream() const;
+
+  /**
+   * Set the stream number that #nextHostStream will reserve next, e.g. to
+   * repeat the stream numbers of a sequence of bulk operations over
+   * another range of elements.
+   *
+   * @param s Stream number, from #tellHostStream.
+   */
+  void seekHostStream(const boost::uint64_t s);
+
+  /**
+   * Start drawing host variates from a replayable stream.
+   *
+   * @param stream The stream.
+   *
+   * Not for use by several threads at once, nor on device.
+   */
+  void startReplay(ReplayStream& stream);
+
+  /**
+   * Stop drawing host variates from a replayable stream.
+   */
+  void stopReplay();
+
+  /**
+   * Is a replayable stream in use?
+   */
+  bool isReplaying() const;
+
 #ifdef ENABLE_CUDA
   /**
    * Get a thread's random number generator.
@@ -265,6 +337,18 @@ public:
    */
   RngHost* hostRngs;
 
+  /**
+   * Common random number generator on host, seeded identically for any
+   * number of threads, from which the streams of bulk operations are
+   * forked.
+   */
+  RngHost* hostCommonRng;
+
+  /**
+   * Next stream number of #hostCommonRng.
+   */
+  boost::uint64_t* hostCommonStream;
+
 #ifdef ENABLE_CUDA
   /**
    * Random number generators on device.
@@ -279,9 +363,58 @@ public:
    */
   bool own;
 };
+
+/**
+ * Replay of a ReplayStream for the lifetime of an object.
+ *
+ * @ingroup math_rng
+ *
+ * The replay is started on construction and stopped on destruction, so
+ * that it is stopped however the scope is left, including by an exception.
+ */
+class ReplayScope {
+public:
+  /**
+   * Constructor.
+   *
+   * @param rng Random number generator.
+   * @param stream The stream.
+   * @param replay Replay? If false, the object does nothing.
+   */
+  ReplayScope(Random& rng, ReplayStream& stream, const bool replay = true);
+
+  /**
+   * Destructor.
+   */
+  ~ReplayScope();
+
+private:
+  /**
+   * Copy constructor, not implemented.
+   */
+  ReplayScope(const ReplayScope& o);
+
+  /**
+   * Assignment operator, not implemented.
+   */
+  ReplayScope& operator=(const ReplayScope& o);
+
+  /**
+   * Random number generator.
+   */
+  Random& rng;
+
+  /**
+   * Is the replay started?
+   */
+  bool replay;
+};
 }
 
 #include "../host/random/RandomHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/random/RandomSSE.hpp"
+#endif
 #ifdef ENABLE_CUDA
 #include "../cuda/random/RandomGPU.hpp"
 #endif
@@ -292,26 +425,41 @@ inline void bi::Random::seed(const unsigned seed) {
 
 template<class T1>
 inline T1 bi::Random::uniformInt(const T1 lower, const T1 upper) {
+  if (isReplaying()) {
+    return getHostStream(nextHostStream(), 0).uniformInt(lower, upper);
+  }
   return getHostRng().uniformInt(lower, upper);
 }
 
 template<class V1>
 inline typename V1::difference_type bi::Random::multinomial(const V1 lps) {
+  if (isReplaying()) {
+    return getHostStream(nextHostStream(), 0).multinomial(lps);
+  }
   return getHostRng().multinomial(lps);
 }
 
 template<class T1>
 inline T1 bi::Random::uniform(const T1 lower, const T1 upper) {
+  if (isReplaying()) {
+    return getHostStream(nextHostStream(), 0).uniform(lower, upper);
+  }
   return getHostRng().uniform(lower, upper);
 }
 
 template<class T1>
 inline T1 bi::Random::gaussian(const T1 mu, const T1 sigma) {
+  if (isReplaying()) {
+    return getHostStream(nextHostStream(), 0).gaussian(mu, sigma);
+  }
   return getHostRng().gaussian(mu, sigma);
 }
 
 template<class T1>
 inline T1 bi::Random::gamma(const T1 alpha, const T1 beta) {
+  if (isReplaying()) {
+    return getHostStream(nextHostStream(), 0).gamma(alpha, beta);
+  }
   return getHostRng().gamma(alpha, beta);
 }
 
@@ -320,6 +468,8 @@ void bi::Random::uniforms(V1 x, const typename V1::value_type lower,
     const typename V1::value_type upper) {
 #ifdef ENABLE_CUDA
   typedef typename boost::mpl::if_c<V1::on_device,RandomGPU,RandomHost>::type impl;
+#elif defined(ENABLE_SSE)
+  typedef RandomSSE impl;
 #else
   typedef RandomHost impl;
 #endif
@@ -331,6 +481,8 @@ void bi::Random::gaussians(V1 x, const typename V1::value_type mu,
     const typename V1::value_type sigma) {
 #ifdef ENABLE_CUDA
   typedef typename boost::mpl::if_c<V1::on_device,RandomGPU,RandomHost>::type impl;
+#elif defined(ENABLE_SSE)
+  typedef RandomSSE impl;
 #else
   typedef RandomHost impl;
 #endif
@@ -342,6 +494,8 @@ void bi::Random::gammas(V1 x, const typename V1::value_type alpha,
     const typename V1::value_type beta) {
 #ifdef ENABLE_CUDA
   typedef typename boost::mpl::if_c<V1::on_device,RandomGPU,RandomHost>::type impl;
+#elif defined(ENABLE_SSE)
+  typedef RandomSSE impl;
 #else
   typedef RandomHost impl;
 #endif
@@ -353,6 +507,8 @@ void bi::Random::betas(V1 x, const typename V1::value_type alpha,
     const typename V1::value_type beta) {
 #ifdef ENABLE_CUDA
   typedef typename boost::mpl::if_c<V1::on_device,RandomGPU,RandomHost>::type impl;
+#elif defined(ENABLE_SSE)
+  typedef RandomSSE impl;
 #else
   typedef RandomHost impl;
 #endif
@@ -373,6 +529,66 @@ inline bi::RngHost& bi::Random::getHostRng() {
   return hostRngs[bi_omp_tid];
 }
 
+inline boost::uint64_t bi::Random::nextHostStream() {
+  boost::uint64_t s;
+
+  #pragma omp critical(bi_random_next_host_stream)
+  s = (*hostCommonStream)++;
+
+  return s;
+}
+
+inline bi::RngHost bi::Random::getHostStream(const boost::uint64_t s,
+    const int j) const {
+  RngHost rng1(*hostCommonRng);
+  rng1.stream(s, j);
+  return rng1;
+}
+
+inline boost::uint64_t bi::Random::tellHostStream() const {
+  return *hostCommonStream;
+}
+
+inline void bi::Random::seekHostStream(const boost::uint64_t s) {
+  *hostCommonStream = s;
+}
+
+inline void bi::Random::startReplay(ReplayStream& stream) {
+  /* pre-condition */
+  BI_ASSERT(!isReplaying());
+
+  /* streams with only the second-highest bit set, clear of those of bulk
+   * operations and per-thread generators, see RandomHost::seeds() */
+  stream.start(*hostCommonStream);
+  *hostCommonStream = static_cast<boost::uint64_t>(1) << 62;
+  hostCommonRng->rng.setReplay(&stream);
+}
+
+inline void bi::Random::stopReplay() {
+  /* pre-condition */
+  BI_ASSERT(isReplaying());
+
+  *hostCommonStream = hostCommonRng->rng.getReplay()->stop();
+  hostCommonRng->rng.setReplay(NULL);
+}
+
+inline bool bi::Random::isReplaying() const {
+  return hostCommonRng->rng.getReplay() != NULL;
+}
+
+inline bi::ReplayScope::ReplayScope(Random& rng, ReplayStream& stream,
+    const bool replay) : rng(rng), replay(replay) {
+  if (replay) {
+    rng.startReplay(stream);
+  }
+}
+
+inline bi::ReplayScope::~ReplayScope() {
+  if (replay) {
+    rng.stopReplay();
+  }
+}
+
 #ifdef ENABLE_CUDA
 //inline curandState& bi::Random::getDevRng(const int p) {
 //  return devRngs[p];
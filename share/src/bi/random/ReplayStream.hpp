@@ -0,0 +1,249 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_RANDOM_REPLAYSTREAM_HPP
+#define BI_RANDOM_REPLAYSTREAM_HPP
+
+#include "../math/scalar.hpp"
+
+#include "boost/cstdint.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * Recorded stream of auxiliary variates, for correlated pseudo-marginal
+ * methods.
+ *
+ * @ingroup math_rng
+ *
+ * While a replay is active (see Random::startReplay()), host generators
+ * draw each block of four raw variates from four latent standard Gaussian
+ * variates, mapped to uniform by the Gaussian distribution function, rather
+ * than from PhiloxHost directly. The latent variates of each block are
+ * identified by its counter, and recorded. When a later replay reaches the
+ * same counter, the recorded variates \f$z\f$ are moved by a
+ * Crank--Nicolson step,
+ *
+ * \f[z' = \rho z + \sqrt{1 - \rho^2}\,\epsilon,\quad
+ * \epsilon \sim \mathcal{N}(0,1),\f]
+ *
+ * rather than drawn afresh, so that the variates of successive replays, and
+ * all that is computed from them, are correlated. Blocks not yet recorded
+ * are drawn afresh, which is the same step from variates not yet looked at.
+ * This is the proposal of @ref Deligiannidis2018
+ * "Deligiannidis, Doucet \& Pitt (2018)" for the auxiliary variates of a
+ * particle filter.
+ *
+ * The variates of a replay replace those recorded only if accept() is
+ * called after it; reject() keeps those recorded. Only blocks reached in
+ * the accepted replay are kept. The others do not enter into its results,
+ * and forgetting them is a Gibbs step on variates independent of the
+ * target.
+ *
+ * Recorded variates are only read during a replay, so that generators on
+ * different threads may use the stream concurrently. Moved variates are
+ * logged separately for each thread, and merged by accept().
+ */
+class ReplayStream {
+public:
+  /**
+   * Constructor.
+   *
+   * @param rho Correlation of the Crank--Nicolson step. Zero gives
+   * independent replays.
+   */
+  ReplayStream(const real rho = 0.0);
+
+  /**
+   * Start replay. Called by Random::startReplay().
+   *
+   * @param stream Next stream number of the common host generator, to be
+   * restored by stop().
+   */
+  void start(const boost::uint64_t stream);
+
+  /**
+   * Stop replay. Called by Random::stopReplay().
+   *
+   * @return Stream number given to start().
+   */
+  boost::uint64_t stop();
+
+  /**
+   * Keep the variates of the last replay.
+   */
+  void accept();
+
+  /**
+   * Discard the variates of the last replay.
+   */
+  void reject();
+
+  /**
+   * Number of recorded blocks.
+   */
+  int size() const;
+
+  /**
+   * Generate a block of variates. Called by PhiloxHost.
+   *
+   * @param key Key of generator.
+   * @param ctr Counter of generator.
+   * @param[out] out Variates.
+   */
+  void generate(const boost::uint32_t key[2], const boost::uint32_t ctr[4],
+      boost::uint32_t out[4]);
+
+private:
+  /**
+   * Latent variates of one block.
+   */
+  struct block {
+    /**
+     * Counter.
+     */
+    boost::uint32_t ctr[4];
+
+    /**
+     * Latent variates.
+     */
+    real z[4];
+
+    /**
+     * Order by counter.
+     */
+    bool operator<(const block& o) const;
+
+    /**
+     * Same counter?
+     */
+    bool operator==(const block& o) const;
+  };
+
+  /**
+   * Correlation.
+   */
+  real rho;
+
+  /**
+   * Number of replays started, which keys the innovations of each.
+   */
+  boost::uint32_t epoch;
+
+  /**
+   * Stream number to restore on stop().
+   */
+  boost::uint64_t saved;
+
+  /**
+   * Recorded blocks, sorted by counter.
+   */
+  std::vector<block> blocks;
+
+  /**
+   * Blocks of the current replay, one log for each thread.
+   */
+  std::vector<std::vector<block> > logs;
+};
+}
+
+#include "../host/random/PhiloxHost.hpp"
+#include "../math/function.hpp"
+#include "../misc/omp.hpp"
+
+#include <algorithm>
+
+inline bi::ReplayStream::ReplayStream(const real rho) :
+    rho(rho), epoch(0), saved(0), logs(bi_omp_max_threads) {
+  //
+}
+
+inline void bi::ReplayStream::start(const boost::uint64_t stream) {
+  saved = stream;
+  ++epoch;
+  for (int i = 0; i < int(logs.size()); ++i) {
+    logs[i].clear();
+  }
+}
+
+inline boost::uint64_t bi::ReplayStream::stop() {
+  return saved;
+}
+
+inline void bi::ReplayStream::accept() {
+  blocks.clear();
+  for (int i = 0; i < int(logs.size()); ++i) {
+    blocks.insert(blocks.end(), logs[i].begin(), logs[i].end());
+    logs[i].clear();
+  }
+
+  /* copies of a generator may reach the same counter more than once, but
+   * give the same variates each time */
+  std::sort(blocks.begin(), blocks.end());
+  blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+}
+
+inline void bi::ReplayStream::reject() {
+  for (int i = 0; i < int(logs.size()); ++i) {
+    logs[i].clear();
+  }
+}
+
+inline int bi::ReplayStream::size() const {
+  return blocks.size();
+}
+
+inline void bi::ReplayStream::generate(const boost::uint32_t key[2],
+    const boost::uint32_t ctr[4], boost::uint32_t out[4]) {
+  static const double TWO32 = 4294967296.0;
+  static const double TWO_PI = 6.28318530717958647692;
+  static const double SQRT_HALF = 0.70710678118654752440;
+
+  const double sigma = bi::sqrt(1.0 - static_cast<double>(rho)*rho);
+  boost::uint32_t key1[2], w[4];
+  double u1, u2, r, eps[4], u;
+  int i;
+
+  /* innovations, by Box-Muller from a key that differs between replays */
+  key1[0] = key[0];
+  key1[1] = key[1] + 0x9E3779B9u*epoch;
+  PhiloxHost::bijection(key1, ctr, w);
+  for (i = 0; i < 4; i += 2) {
+    u1 = (w[i] + 0.5)/TWO32;
+    u2 = (w[i + 1] + 0.5)/TWO32;
+    r = bi::sqrt(-2.0*bi::log(u1));
+    eps[i] = r*bi::cos(TWO_PI*u2);
+    eps[i + 1] = r*bi::sin(TWO_PI*u2);
+  }
+
+  /* recorded variates, if any */
+  block b;
+  std::copy(ctr, ctr + 4, b.ctr);
+  std::vector<block>::const_iterator iter = std::lower_bound(blocks.begin(),
+      blocks.end(), b);
+  const bool found = iter != blocks.end() && *iter == b;
+
+  /* move, and map to raw variates */
+  for (i = 0; i < 4; ++i) {
+    b.z[i] = found ? rho*iter->z[i] + sigma*eps[i] : eps[i];
+    u = 0.5*bi::erfc(-b.z[i]*SQRT_HALF)*TWO32;
+    out[i] = (u < TWO32 - 1.0) ? static_cast<boost::uint32_t>(u) :
+        0xFFFFFFFFu;
+  }
+  logs[bi_omp_tid].push_back(b);
+}
+
+inline bool bi::ReplayStream::block::operator<(const block& o) const {
+  return std::lexicographical_compare(ctr, ctr + 4, o.ctr, o.ctr + 4);
+}
+
+inline bool bi::ReplayStream::block::operator==(const block& o) const {
+  return std::equal(ctr, ctr + 4, o.ctr);
+}
+
+#endif
@@ -31,6 +31,11 @@
  * Del Moral, P. & Murray L. M. Sequential Monte Carlo with highly informative
  * observations. <b>2014</b>. http://arxiv.org/abs/1405.4081.
  *
+ * @anchor Deligiannidis2018
+ * Deligiannidis, G.; Doucet, A. & Pitt, M. K. The correlated pseudomarginal
+ * method. <i>Journal of the Royal Statistical Society B</i>, <b>2018</b>, 80,
+ * 839-870.
+ *
  * @anchor Gray2001
  * Gray, A. G. & Moore, A. W. `N-Body' Problems in Statistical
  * Learning. <i>Advances in Neural Information Processing Systems</i>,
@@ -59,6 +64,11 @@
  * Nonlinear %State Space Models. <i>Journal of Computational and
  * Graphical Statistics</i>, <b>1996</b>, 5, 1-25.
  *
+ * @anchor Liu1998
+ * Liu, J. S. & Chen, R. Sequential Monte Carlo Methods for Dynamic
+ * Systems. <i>Journal of the American Statistical Association</i>,
+ * <b>1998</b>, 93, 1032-1044.
+ *
  * @anchor Marsaglia2000
  * Marsaglia, G. & Tsang, W. W. A Simple Method for Generating Gamma
  * Variables. <i>ACM Transactions on Mathematical Software</i>, <b>2000</b>,
@@ -103,6 +113,18 @@
  * filtering within adaptive Metropolis-Hastings sampling, <b>2010</b>.
  * http://arxiv.org/abs/1006.1914
  *
+ * @anchor Salmon2011
+ * Salmon, J. K.; Moraes, M. A.; Dror, R. O. & Shaw, D. E. Parallel random
+ * numbers: As easy as 1, 2, 3. <i>Proceedings of the 2011 International
+ * Conference for High Performance Computing, Networking, Storage and
+ * Analysis</i>, <b>2011</b>, 16:1-16:12.
+ *
+ * @anchor Sandu1997
+ * Sandu, A.; Verwer, J. G.; Blom, J. G.; Spee, E. J.; Carmichael, G. R. &
+ * Potra, F. A. Benchmarking stiff ODE solvers for atmospheric chemistry
+ * problems II: Rosenbrock solvers. <i>Atmospheric Environment</i>,
+ * <b>1997</b>, 31, 3459-3472.
+ *
  * @anchor Sarkka2008
  * Särkkä, S. Unscented Rauch-Tung-Striebel Smoother. <i>IEEE Transactions on
  * Automated Control</i>, <b>2008</b>, 53, 845-849.
@@ -110,4 +132,8 @@
  * @anchor Silverman1986
  * Silverman, B.W. <i>Density Estimation for Statistics and Data
  * Analysis</i>. Chapman and Hall, <b>1986</b>.
+ *
+ * @anchor Skilling2004
+ * Skilling, J. Programming the Hilbert curve. <i>AIP Conference
+ * Proceedings</i>, <b>2004</b>, 707, 381-387.
  */
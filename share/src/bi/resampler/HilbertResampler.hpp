@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_RESAMPLER_HILBERTRESAMPLER_HPP
+#define BI_RESAMPLER_HILBERTRESAMPLER_HPP
+
+#include "Resampler.hpp"
+
+#include "boost/cstdint.hpp"
+
+namespace bi {
+/**
+ * @internal
+ *
+ * Index of a point along a Hilbert curve, by the method of
+ * @ref Skilling2004 "Skilling (2004)".
+ *
+ * @param[in,out] x Coordinates of point, each of @p B bits. Overwritten.
+ * @param D Number of dimensions.
+ * @param B Number of bits per dimension, with <tt>D*B <= 64</tt>.
+ *
+ * @return Index.
+ */
+inline boost::uint64_t hilbert_index(boost::uint32_t* x, const int D,
+    const int B) {
+  /* pre-condition */
+  BI_ASSERT(D > 0 && B > 0 && B <= 32 && D*B <= 64);
+
+  const boost::uint32_t M = static_cast<boost::uint32_t>(1) << (B - 1);
+  boost::uint32_t P, Q, t;
+  boost::uint64_t h = 0;
+  int i, j;
+
+  /* inverse undo of excess work */
+  for (Q = M; Q > 1; Q >>= 1) {
+    P = Q - 1;
+    for (i = 0; i < D; ++i) {
+      if (x[i] & Q) {
+        x[0] ^= P;
+      } else {
+        t = (x[0] ^ x[i]) & P;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  /* Gray encode */
+  for (i = 1; i < D; ++i) {
+    x[i] ^= x[i - 1];
+  }
+  t = 0;
+  for (Q = M; Q > 1; Q >>= 1) {
+    if (x[D - 1] & Q) {
+      t ^= Q - 1;
+    }
+  }
+  for (i = 0; i < D; ++i) {
+    x[i] ^= t;
+  }
+
+  /* interleave bits, most significant first */
+  for (j = B - 1; j >= 0; --j) {
+    for (i = 0; i < D; ++i) {
+      h = (h << 1) | ((x[i] >> j) & 1u);
+    }
+  }
+  return h;
+}
+
+/**
+ * Hilbert curve resampler for particle filter.
+ *
+ * @ingroup method_resampler
+ *
+ * @tparam R Resampler type.
+ *
+ * Orders particles along a Hilbert curve through the bounding box of their
+ * states before resampling with a base resampler of type @p R, so that
+ * particles near each other in the order used by the base resampler are
+ * near each other in state space. Ancestors then change little with small
+ * changes in the weights or in the random variates used by the base
+ * resampler, as needed by the correlated pseudo-marginal method of
+ * @ref Deligiannidis2018 "Deligiannidis, Doucet \& Pitt (2018)". For one
+ * state variable, this is sorting by state.
+ *
+ * The base resampler should select ancestors in order, so should not sort
+ * weights itself. The curve passes through the given columns of the state
+ * only, usually those of the state variables, as the noise variables are
+ * drawn afresh at each step and carry no information on nearness. The first
+ * 64 of these columns are used at most, with <tt>min(64/N, 32)</tt> bits of
+ * each of @c N columns, so that with many state variables particles are
+ * ordered on a coarse grid.
+ */
+template<class R>
+class HilbertResampler: public Resampler {
+public:
+  /**
+   * Constructor.
+   *
+   * @param base Base resampler.
+   * @param start Index of first column of state by which to order
+   * particles.
+   * @param size Number of columns of state by which to order particles.
+   * @param essRel Minimum ESS, as proportion of total number of particles,
+   * to trigger resampling.
+   * @param bridgeEssRel Minimum ESS, as proportion of total number of
+   * particles, to trigger resampling after bridge weighting.
+   */
+  HilbertResampler(R* base, const int start, const int size,
+      const double essRel = 0.5, const double bridgeEssRel = 0.5);
+
+  /**
+   * @name High-level interface
+   */
+  //@{
+  /**
+   * @copydoc Resampler::resample(Random&, V1, V2, State<B,L>&)
+   */
+  template<class V1, class V2, class O1>
+  void resample(Random& rng, V1 lws, V2 as, O1 s);
+  //@}
+
+  /**
+   * @name Low-level interface
+   */
+  //@{
+  /**
+   * @copydoc Resampler::ancestors
+   *
+   * Without the state, particles are not ordered along the curve, and
+   * this is the same as the base resampler. Only resample() orders them,
+   * so that filters that select ancestors with this, such as AdaptivePF,
+   * are not used with HilbertResampler.
+   */
+  template<class V1, class V2>
+  void ancestors(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::offspring
+   *
+   * As for ancestors(), particles are not ordered along the curve.
+   */
+  template<class V1, class V2>
+  void offspring(Random& rng, const V1 lws, V2 os, const int P)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * Order particles along Hilbert curve.
+   *
+   * @tparam M1 Matrix type.
+   * @tparam V1 Integral vector type.
+   *
+   * @param X States. Rows index particles.
+   * @param[out] ps Indices of particles, in order.
+   */
+  template<class M1, class V1>
+  static void order(const M1 X, V1 ps);
+  //@}
+
+private:
+  /**
+   * Base resampler.
+   */
+  R* base;
+
+  /**
+   * Index of first column by which to order particles.
+   */
+  int start;
+
+  /**
+   * Number of columns by which to order particles.
+   */
+  int size;
+};
+}
+
+#include "../misc/exception.hpp"
+#include "../math/sim_temp_vector.hpp"
+#include "../math/function.hpp"
+#include "../math/view.hpp"
+#include "../host/math/sim_temp_vector.hpp"
+#include "../host/math/sim_temp_matrix.hpp"
+#include "../primitive/vector_primitive.hpp"
+
+#include <vector>
+#include <algorithm>
+
+template<class R>
+bi::HilbertResampler<R>::HilbertResampler(R* base, const int start,
+    const int size, const double essRel, const double bridgeEssRel) :
+    Resampler(essRel, bridgeEssRel), base(base), start(start), size(size) {
+  /* pre-condition */
+  BI_ASSERT(start >= 0 && size >= 0);
+
+  //
+}
+
+template<class R>
+template<class V1, class V2, class O1>
+void bi::HilbertResampler<R>::resample(Random& rng, V1 lws, V2 as, O1 s) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == s.size1());
+  BI_ASSERT(start + size <= s.size2());
+
+  typename sim_temp_vector<V2>::type ps(lws.size()), as1(as.size());
+  typename sim_temp_vector<V1>::type lws1(lws.size());
+
+  /* resample in order along the curve, then map back */
+  order(columns(s, start, size), ps);
+  bi::gather(ps, lws, lws1);
+  base->ancestors(rng, lws1, as1);
+  bi::gather(as1, ps, as);
+  permute(as);
+  copy(as, s);
+  lws.clear();
+}
+
+template<class R>
+template<class V1, class V2>
+void bi::HilbertResampler<R>::ancestors(Random& rng, const V1 lws, V2 as)
+    throw (ParticleFilterDegeneratedException) {
+  base->ancestors(rng, lws, as);
+}
+
+template<class R>
+template<class V1, class V2>
+void bi::HilbertResampler<R>::offspring(Random& rng, const V1 lws, V2 os,
+    const int P) throw (ParticleFilterDegeneratedException) {
+  base->offspring(rng, lws, os, P);
+}
+
+template<class R>
+template<class M1, class V1>
+void bi::HilbertResampler<R>::order(const M1 X, V1 ps) {
+  /* pre-condition */
+  BI_ASSERT(X.size1() == ps.size());
+
+  typedef typename M1::value_type T1;
+  typedef typename sim_temp_host_matrix<M1>::type host_matrix_type;
+  typedef typename sim_temp_host_vector<V1>::type host_int_vector_type;
+  typedef std::pair<boost::uint64_t,int> key_type;
+
+  const int P = X.size1();
+  const int D = bi::min(static_cast<int>(X.size2()), 64);
+  const int B = (D > 0) ? bi::min(64/D, 32) : 0;
+  const double scale = static_cast<double>(static_cast<boost::uint64_t>(1)
+      << B);
+
+  if (D == 0) {
+    seq_elements(ps, 0);
+    return;
+  }
+
+  host_matrix_type X1(P, X.size2());
+  X1 = X;
+  synchronize(M1::on_device);
+
+  /* bounding box */
+  std::vector<T1> lo(D), hi(D);
+  int p, i;
+  for (i = 0; i < D; ++i) {
+    lo[i] = 0.0;
+    hi[i] = 0.0;
+    bool first = true;
+    for (p = 0; p < P; ++p) {
+      T1 x = X1(p, i);
+      if (bi::is_finite(x)) {
+        if (first || x < lo[i]) {
+          lo[i] = x;
+        }
+        if (first || x > hi[i]) {
+          hi[i] = x;
+        }
+        first = false;
+      }
+    }
+  }
+
+  /* indices along curve */
+  std::vector<key_type> keys(P);
+  #pragma omp parallel private(p, i)
+  {
+    std::vector<boost::uint32_t> x(D);
+    double t;
+
+    #pragma omp for
+    for (p = 0; p < P; ++p) {
+      for (i = 0; i < D; ++i) {
+        t = 0.0;
+        if (bi::is_finite(X1(p, i)) && hi[i] > lo[i]) {
+          t = (X1(p, i) - lo[i])/(hi[i] - lo[i])*scale;
+        }
+        x[i] = static_cast<boost::uint32_t>(bi::min(t, scale - 1.0));
+      }
+      keys[p] = key_type(hilbert_index(&x[0], D, B), p);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  host_int_vector_type ps1(P);
+  for (p = 0; p < P; ++p) {
+    ps1(p) = keys[p].second;
+  }
+  ps = ps1;
+  synchronize(V1::on_device);
+}
+
+#endif
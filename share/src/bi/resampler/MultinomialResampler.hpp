@@ -106,6 +106,13 @@ public:
   template<class V1, Location L>
   void precompute(const V1 lws, MultinomialPrecompute<L>& pre);
 
+  /**
+   * @copydoc Resampler::ancestorsPermute
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * @copydoc Resampler::offspring
    */
@@ -129,6 +136,14 @@ struct precompute_type<MultinomialResampler,L> {
   typedef MultinomialPrecompute<L> type;
 };
 
+/**
+ * @internal
+ */
+template<>
+struct resampler_can_split<MultinomialResampler> {
+  static const bool value = true;
+};
+
 }
 
 #include "../host/resampler/MultinomialResamplerHost.hpp"
@@ -148,12 +163,18 @@ struct precompute_type<MultinomialResampler,L> {
 template<class V1, class V2, class O1>
 void bi::MultinomialResampler::resample(Random& rng, V1 lws, V2 as, O1 s)
     throw (ParticleFilterDegeneratedException) {
-  ancestors(rng, lws, as);
-  permute(as);
+  ancestorsPermute(rng, lws, as);
   copy(as, s);
   lws.clear();
 }
 
+template<class V1, class V2>
+void bi::MultinomialResampler::ancestorsPermute(Random& rng, const V1 lws,
+    V2 as) throw (ParticleFilterDegeneratedException) {
+  ancestors(rng, lws, as);
+  permute(as);
+}
+
 template<class V1, class V2>
 void bi::MultinomialResampler::ancestors(Random& rng, const V1 lws, V2 as)
     throw (ParticleFilterDegeneratedException) {
@@ -66,6 +66,22 @@ public:
   template<class V1>
   bool isTriggeredBridge(const V1 lws) const;
 
+  /**
+   * Is ESS-based condition triggered?
+   *
+   * @param ess ESS, as from reduce().
+   * @param P Number of particles.
+   */
+  bool isTriggered(const double ess, const int P) const;
+
+  /**
+   * Is ESS-based condition for bridge resampling triggered?
+   *
+   * @param ess ESS, as from reduce().
+   * @param P Number of particles.
+   */
+  bool isTriggeredBridge(const double ess, const int P) const;
+
   /**
    * Resample state.
    *
@@ -103,6 +119,24 @@ public:
   void ancestors(Random& rng, const V1 lws, V2 as)
       throw (ParticleFilterDegeneratedException);
 
+  /**
+   * Select ancestors and permute them, as resample() does before copying
+   * particles.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param lws Log-weights.
+   * @param[out] as Ancestors, permuted.
+   *
+   * Only for resamplers with resampler_can_split. Followed by copy() with
+   * @p as and clearing @p lws, this is the same as resample().
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
+
   /**
    * Select offspring.
    *
@@ -260,6 +294,33 @@ public:
   template<class V1>
   static void normalise(V1 lws);
 
+  /**
+   * Normalise log-weights after resampling, given their log-sum.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param lW Log of sum of weights, as from reduce().
+   */
+  template<class V1>
+  static void normalise(V1 lws, const double lW);
+
+  /**
+   * Compute log of sum of weights and ESS of log-weights in a single pass.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param[out] lW Log of sum of weights.
+   * @param[out] ess ESS.
+   *
+   * The results may be passed to the overloads of isTriggered(),
+   * isTriggeredBridge() and normalise() that accept them, so that the
+   * log-weights need only be read once for all of these.
+   */
+  template<class V1>
+  static void reduce(const V1 lws, double& lW, double& ess);
+
   /**
    * Compute effective sample size (ESS) of log-weights.
    *
@@ -375,6 +436,75 @@ public:
    */
   template<class V1>
   static void permute(V1 as);
+
+  /**
+   * @copydoc Resampler::copy(const V1, M1)
+   *
+   * Only rows with <tt>as(i) != i</tt> are copied. Their indices are first
+   * compacted into a list, then the copy proceeds column by column, each
+   * column split into contiguous ranges of that list over threads. Within
+   * a persistent team, the work is shared with the team, see copyTeam().
+   */
+  template<class V1, class M1>
+  static void copy(const V1 as, M1 X);
+
+  /**
+   * Copy, sharing the work among the threads of the current team.
+   *
+   * As the team has no shared storage for a list of rows to be copied,
+   * each column is split into contiguous ranges of rows instead, with rows
+   * that are their own ancestors skipped.
+   */
+  template<class V1, class M1>
+  static void copyTeam(const V1 as, M1 X);
+
+private:
+  /**
+   * Number of offspring of a particle.
+   *
+   * @tparam Cumulative Is @p os a cumulative offspring vector?
+   * @tparam V1 Integral vector type.
+   *
+   * @param os Offspring, or cumulative offspring.
+   * @param i Particle index.
+   */
+  template<bool Cumulative, class V1>
+  static int offspring(const V1 os, const int i);
+
+  /**
+   * Range of indices handled by one thread, for passes with a prefix sum
+   * across threads.
+   *
+   * @param P Number of indices.
+   * @param t Block index.
+   * @param T Number of blocks.
+   * @param[out] start Start of range.
+   * @param[out] end End of range.
+   */
+  static void block(const int P, const int t, const int T, int& start,
+      int& end);
+
+  /**
+   * Compute already-permuted ancestor vector from offspring vector, in
+   * parallel.
+   *
+   * @tparam Cumulative Is @p os a cumulative offspring vector?
+   * @tparam V1 Integral vector type.
+   * @tparam V2 Integral vector type.
+   * @tparam V3 Integral vector type.
+   *
+   * @param os Offspring, or cumulative offspring.
+   * @param[out] as Ancestors.
+   * @param rest Further ancestors, not in @p os, to place after all others.
+   *
+   * Each particle with at least one offspring is its own first ancestor.
+   * Its remaining offspring, then the elements of @p rest, are written to
+   * the places of particles with no offspring, in order. Offsets into those
+   * places are obtained by prefix sums over blocks of particles.
+   */
+  template<bool Cumulative, class V1, class V2, class V3>
+  static void offspringToAncestorsPermute(const V1 os, V2 as,
+      const V3 rest);
 };
 
 /**
@@ -434,6 +564,12 @@ public:
   template<class V1>
   static void permute(V1 as);
 
+  /**
+   * @copydoc Resampler::copy(const V1, M1)
+   */
+  template<class V1, class M1>
+  static void copy(const V1 as, M1 X);
+
   /**
    * First stage of permutation.
    *
@@ -486,6 +622,15 @@ inline bool bi::Resampler::isTriggeredBridge(const V1 lws) const {
   return bridgeEssRel >= 1.0 || ess(lws) < bridgeEssRel * lws.size();
 }
 
+inline bool bi::Resampler::isTriggered(const double ess, const int P) const {
+  return essRel >= 1.0 || ess < essRel * P;
+}
+
+inline bool bi::Resampler::isTriggeredBridge(const double ess,
+    const int P) const {
+  return bridgeEssRel >= 1.0 || ess < bridgeEssRel * P;
+}
+
 template<class V1, class V2>
 void bi::Resampler::ancestorsToOffspring(const V1 as, V2 os) {
   typedef typename boost::mpl::if_c<V1::on_device,ResamplerGPU,ResamplerHost>::type impl;
@@ -525,7 +670,8 @@ void bi::Resampler::permute(const V1 as) {
 
 template<class V1, class M1>
 void bi::Resampler::copy(const V1 as, M1 s) {
-  gather_rows(as, s, s);
+  typedef typename boost::mpl::if_c<M1::on_device,ResamplerGPU,ResamplerHost>::type impl;
+  impl::copy(as, s);
 }
 
 template<class V1, class T1>
@@ -551,20 +697,38 @@ void bi::Resampler::copy(const V1 as, const M1 X1, M2 X2) {
 
 template<class V1>
 void bi::Resampler::normalise(V1 lws) {
+  double lW, ess;
+  reduce(lws, lW, ess);
+  normalise(lws, lW);
+}
+
+template<class V1>
+void bi::Resampler::normalise(V1 lws, const double lW) {
   typedef typename V1::value_type T1;
-  T1 lW = logsumexp_reduce(lws);
-  addscal_elements(lws, bi::log(static_cast<T1>(lws.size())) - lW, lws);
+  T1 a = bi::log(static_cast<T1>(lws.size())) - lW;
+  addscal_elements(lws, a, lws);
 }
 
 template<class V1>
-typename V1::value_type bi::Resampler::ess(const V1 lws) {
-  typename V1::value_type result = ess_reduce(lws);
+void bi::Resampler::reduce(const V1 lws, double& lW, double& ess) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() > 0);
 
-  if (result > 0.0) {
-    return result;
-  } else {
-    return 0.0;  // may be nan
+  typename V1::value_type mx, sum1, sum2;
+  max_sumexp_reduce(lws, mx, sum1, sum2);
+
+  lW = mx + bi::log(static_cast<double>(sum1));
+  ess = static_cast<double>(sum1)*sum1/sum2;
+  if (!(ess > 0.0)) {
+    ess = 0.0;  // may be nan
   }
 }
 
+template<class V1>
+typename V1::value_type bi::Resampler::ess(const V1 lws) {
+  double lW, ess;
+  reduce(lws, lW, ess);
+  return ess;
+}
+
 #endif
@@ -0,0 +1,14 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#include "ResidualResampler.hpp"
+
+bi::ResidualResampler::ResidualResampler(const bool systematic,
+    const double essRel, const double bridgeEssRel) :
+    Resampler(essRel, bridgeEssRel), systematic(systematic) {
+  //
+}
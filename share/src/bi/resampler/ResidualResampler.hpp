@@ -0,0 +1,273 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_RESAMPLER_RESIDUALRESAMPLER_HPP
+#define BI_RESAMPLER_RESIDUALRESAMPLER_HPP
+
+#include "Resampler.hpp"
+#include "../cuda/cuda.hpp"
+#include "../random/Random.hpp"
+#include "../misc/exception.hpp"
+
+namespace bi {
+/**
+ * ResidualResampler implementation on host.
+ */
+class ResidualResamplerHost: public ResamplerHost {
+public:
+  /**
+   * @copydoc ResidualResampler::offspring
+   */
+  template<class V1, class V2>
+  static void offspring(Random& rng, const V1 lws, V2 os, const int n,
+      const bool systematic) throw (ParticleFilterDegeneratedException);
+
+  /**
+   * Deterministic part of residual resampling.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   * @tparam V3 Vector type.
+   *
+   * @param lws Log-weights.
+   * @param[out] os Offspring, @f$\lfloor nw^i\rfloor@f$ for normalised
+   * weights @f$w^i@f$.
+   * @param[out] rs Residuals, @f$nw^i - \lfloor nw^i\rfloor@f$.
+   * @param n Number of offspring.
+   *
+   * @return Number of offspring remaining to be drawn from the residuals.
+   */
+  template<class V1, class V2, class V3>
+  static int deterministic(const V1 lws, V2 os, V3 rs, const int n)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * Random part of residual resampling.
+   *
+   * @tparam V1 Vector type.
+   * @tparam V2 Integer vector type.
+   *
+   * @param[in,out] rng Random number generator.
+   * @param rs Residuals, as from deterministic().
+   * @param[in,out] os Offspring, to which the offspring drawn from the
+   * residuals are added.
+   * @param R Number of offspring to draw.
+   * @param systematic True to draw systematically, false to draw
+   * multinomially.
+   */
+  template<class V1, class V2>
+  static void residual(Random& rng, const V1 rs, V2 os, const int R,
+      const bool systematic);
+
+  /**
+   * Remove offspring in excess of the deterministic part.
+   *
+   * @tparam V1 Integer vector type.
+   *
+   * @param[in,out] os Offspring.
+   * @param e Number of offspring to remove.
+   *
+   * The floors of @f$nw^i@f$ cannot sum to more than @f$n@f$, but with
+   * rounding in the normalisation they may. One offspring is removed from
+   * the particle with the most, @p e times over.
+   */
+  template<class V1>
+  static void overshoot(V1 os, const int e);
+};
+
+#ifdef ENABLE_SSE
+/**
+ * ResidualResampler implementation on host, using SSE instructions.
+ *
+ * Only the deterministic part differs from ResidualResamplerHost, which
+ * is a dense pass over the weights; the random part is dominated by the
+ * draws and search.
+ */
+class ResidualResamplerSSE: public ResidualResamplerHost {
+public:
+  /**
+   * @copydoc ResidualResamplerHost::deterministic
+   */
+  template<class V1, class V2, class V3>
+  static int deterministic(const V1 lws, V2 os, V3 rs, const int n)
+      throw (ParticleFilterDegeneratedException);
+};
+#endif
+
+/**
+ * ResidualResampler implementation on device.
+ */
+class ResidualResamplerGPU: public ResamplerGPU {
+public:
+  /**
+   * @copydoc ResidualResampler::offspring
+   */
+  template<class V1, class V2>
+  static void offspring(Random& rng, const V1 lws, V2 os, const int n,
+      const bool systematic) throw (ParticleFilterDegeneratedException);
+};
+
+/**
+ * Residual resampler for particle filter.
+ *
+ * @ingroup method_resampler
+ *
+ * Residual resampler based on the scheme of
+ * @ref Liu1998 "Liu & Chen (1998)". Each particle first receives
+ * @f$\lfloor Pw^i\rfloor@f$ offspring, for normalised weight @f$w^i@f$,
+ * with no random draws and no search. The remaining offspring are drawn
+ * from the residual weights, either multinomially or, for the
+ * residual-systematic variant, systematically. Usually fewer than half of
+ * the offspring remain for the random part, and the variance of the
+ * offspring counts is lower than for multinomial resampling.
+ */
+class ResidualResampler: public Resampler {
+public:
+  /**
+   * Constructor.
+   *
+   * @param systematic True to draw the residual offspring systematically,
+   * false to draw them multinomially.
+   * @param essRel Minimum ESS, as proportion of total number of particles,
+   * to trigger resampling.
+   * @param bridgeEssRel Minimum ESS, as proportion of total number of
+   * particles, to trigger resampling after bridge weighting.
+   */
+  ResidualResampler(const bool systematic = false, const double essRel = 0.5,
+      const double bridgeEssRel = 0.5);
+
+  /**
+   * @name High-level interface
+   */
+  //@{
+  /**
+   * @copydoc Resampler::resample(Random&, V1, V2, O1&)
+   */
+  template<class V1, class V2, class O1>
+  void resample(Random& rng, V1 lws, V2 as, O1 s)
+      throw (ParticleFilterDegeneratedException);
+  //@}
+
+  /**
+   * @name Low-level interface
+   */
+  //@{
+  /**
+   * @copydoc Resampler::offspring
+   */
+  template<class V1, class V2>
+  void offspring(Random& rng, const V1 lws, V2 os, const int n)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::cumulativeOffspring
+   */
+  template<class V1, class V2>
+  void cumulativeOffspring(Random& rng, const V1 lws, V2 Os, const int n)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::ancestors
+   */
+  template<class V1, class V2>
+  void ancestors(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::ancestorsPermute
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
+  //@}
+
+protected:
+  /**
+   * Draw residual offspring systematically?
+   */
+  bool systematic;
+};
+
+/**
+ * @internal
+ */
+template<>
+struct resampler_can_split<ResidualResampler> {
+  static const bool value = true;
+};
+}
+
+#include "../host/resampler/ResidualResamplerHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/resampler/ResidualResamplerSSE.hpp"
+#endif
+#ifdef __CUDACC__
+#include "../cuda/resampler/ResidualResamplerGPU.cuh"
+#endif
+
+#include "../primitive/vector_primitive.hpp"
+#include "../math/sim_temp_vector.hpp"
+
+#include "boost/mpl/if.hpp"
+
+template<class V1, class V2, class O1>
+void bi::ResidualResampler::resample(Random& rng, V1 lws, V2 as, O1 s)
+    throw (ParticleFilterDegeneratedException) {
+  ancestorsPermute(rng, lws, as);
+  lws.clear();
+  copy(as, s);
+}
+
+template<class V1, class V2>
+void bi::ResidualResampler::ancestorsPermute(Random& rng, const V1 lws,
+    V2 as) throw (ParticleFilterDegeneratedException) {
+  const int P = lws.size();
+  typename sim_temp_vector<V2>::type Os(P);
+
+  cumulativeOffspring(rng, lws, Os, P);
+  cumulativeOffspringToAncestorsPermute(Os, as);
+}
+
+template<class V1, class V2>
+void bi::ResidualResampler::offspring(Random& rng, const V1 lws, V2 os,
+    const int n) throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == os.size());
+  BI_ASSERT(V1::on_device == V2::on_device);
+
+  typedef typename boost::mpl::if_c<V1::on_device,ResidualResamplerGPU,
+      ResidualResamplerHost>::type impl;
+  impl::offspring(rng, lws, os, n, systematic);
+
+#ifndef NDEBUG
+  int m = sum_reduce(os);
+  BI_ASSERT_MSG(m == n,
+      "Residual resampler gives " << m << " offspring, should give " << n);
+#endif
+}
+
+template<class V1, class V2>
+void bi::ResidualResampler::cumulativeOffspring(Random& rng, const V1 lws,
+    V2 Os, const int n) throw (ParticleFilterDegeneratedException) {
+  /* pre-condition */
+  BI_ASSERT(lws.size() == Os.size());
+
+  typename sim_temp_vector<V2>::type os(lws.size());
+  offspring(rng, lws, os, n);
+  sum_inclusive_scan(os, Os);
+}
+
+template<class V1, class V2>
+void bi::ResidualResampler::ancestors(Random& rng, const V1 lws, V2 as)
+    throw (ParticleFilterDegeneratedException) {
+  typename sim_temp_vector<V2>::type Os(lws.size());
+
+  cumulativeOffspring(rng, lws, Os, as.size());
+  cumulativeOffspringToAncestors(Os, as);
+}
+
+#endif
@@ -111,6 +111,13 @@ public:
   template<class V1, class V2, class V3, class V4>
   void ancestors(Random& rng, const V1 lws, V2 as, int P, bool sorted,
       V3 lws1, V4 ps, V3 Ws) throw (ParticleFilterDegeneratedException);
+
+  /**
+   * @copydoc Resampler::ancestorsPermute
+   */
+  template<class V1, class V2>
+  void ancestorsPermute(Random& rng, const V1 lws, V2 as)
+      throw (ParticleFilterDegeneratedException);
   //@}
 
 protected:
@@ -133,6 +140,14 @@ protected:
    */
   bool sort;
 };
+
+/**
+ * @internal
+ */
+template<>
+struct resampler_can_split<StratifiedResampler> {
+  static const bool value = true;
+};
 }
 
 #include "../host/resampler/StratifiedResamplerHost.hpp"
@@ -158,13 +173,19 @@ protected:
 template<class V1, class V2, class O1>
 void bi::StratifiedResampler::resample(Random& rng, V1 lws, V2 as, O1 s)
     throw (ParticleFilterDegeneratedException) {
+  ancestorsPermute(rng, lws, as);
+  lws.clear();
+  copy(as, s);
+}
+
+template<class V1, class V2>
+void bi::StratifiedResampler::ancestorsPermute(Random& rng, const V1 lws,
+    V2 as) throw (ParticleFilterDegeneratedException) {
   const int P = lws.size();
   typename sim_temp_vector<V2>::type Os(P);
 
   cumulativeOffspring(rng, lws, Os, P);
   cumulativeOffspringToAncestorsPermute(Os, as);
-  lws.clear();
-  copy(as, s);
 }
 
 template<class V1, class V2>
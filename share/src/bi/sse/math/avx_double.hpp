@@ -72,6 +72,7 @@ union avx_double {
 
   avx_double& operator=(const double& o) {
     packed = _mm256_set1_pd(o);
+    return *this;
   }
 };
 
@@ -368,6 +369,31 @@ BI_FORCE_INLINE inline double max_reduce(const avx_double x) {
   return bi::max(bi::max_reduce(x.unpacked.a), bi::max_reduce(x.unpacked.b));
 }
 
+BI_FORCE_INLINE inline double min_reduce(const avx_double x) {
+  return bi::min(bi::min_reduce(x.unpacked.a), bi::min_reduce(x.unpacked.b));
+}
+
+/**
+ * Select elements by mask.
+ *
+ * @param mask Mask, as returned by a comparison operator.
+ * @param x Elements to select where the mask is set.
+ * @param y Elements to select where the mask is not set.
+ */
+BI_FORCE_INLINE inline avx_double mask_select(const avx_double mask,
+    const avx_double x, const avx_double y) {
+  avx_double res;
+  res.packed = _mm256_blendv_pd(y.packed, x.packed, mask.packed);
+  return res;
+}
+
+/**
+ * Is any element of a mask set?
+ */
+BI_FORCE_INLINE inline bool mask_any(const avx_double mask) {
+  return _mm256_movemask_pd(mask.packed) != 0;
+}
+
 }
 
 #endif
@@ -72,6 +72,7 @@ union avx_float {
 
   avx_float& operator=(const float& o) {
     packed = _mm256_set1_ps(o);
+    return *this;
   }
 };
 
@@ -363,6 +364,31 @@ BI_FORCE_INLINE inline float max_reduce(const avx_float x) {
   return bi::max(bi::max_reduce(x.unpacked.a), bi::max_reduce(x.unpacked.b));
 }
 
+BI_FORCE_INLINE inline float min_reduce(const avx_float x) {
+  return bi::min(bi::min_reduce(x.unpacked.a), bi::min_reduce(x.unpacked.b));
+}
+
+/**
+ * Select elements by mask.
+ *
+ * @param mask Mask, as returned by a comparison operator.
+ * @param x Elements to select where the mask is set.
+ * @param y Elements to select where the mask is not set.
+ */
+BI_FORCE_INLINE inline avx_float mask_select(const avx_float mask,
+    const avx_float x, const avx_float y) {
+  avx_float res;
+  res.packed = _mm256_blendv_ps(y.packed, x.packed, mask.packed);
+  return res;
+}
+
+/**
+ * Is any element of a mask set?
+ */
+BI_FORCE_INLINE inline bool mask_any(const avx_float mask) {
+  return _mm256_movemask_ps(mask.packed) != 0;
+}
+
 }
 
 #endif
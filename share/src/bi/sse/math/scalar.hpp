@@ -12,6 +12,8 @@
 
 #include "../../math/scalar.hpp"
 
+#include <cstddef>
+
 #ifdef ENABLE_SSE
 #include "sse_float.hpp"
 #include "sse_double.hpp"
@@ -34,6 +36,15 @@ typedef sse_double simd_real;
 #else
 typedef real simd_real;
 #endif
+
+/**
+ * Is a buffer aligned for loads and stores of simd_real?
+ *
+ * @param ptr Buffer.
+ */
+inline bool simd_aligned(const void* ptr) {
+  return reinterpret_cast<std::size_t>(ptr) % sizeof(simd_real) == 0;
+}
 }
 
 #define BI_SIMD_SIZE (sizeof(simd_real)/sizeof(real))
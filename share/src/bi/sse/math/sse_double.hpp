@@ -73,6 +73,7 @@ union sse_double {
 
   sse_double& operator=(const double& o) {
     packed = _mm_set1_pd(o);
+    return *this;
   }
 };
 
@@ -369,6 +370,31 @@ BI_FORCE_INLINE inline double max_reduce(const sse_double x) {
   return bi::max(x.unpacked.a, x.unpacked.b);
 }
 
+BI_FORCE_INLINE inline double min_reduce(const sse_double x) {
+  return bi::min(x.unpacked.a, x.unpacked.b);
+}
+
+/**
+ * Select elements by mask.
+ *
+ * @param mask Mask, as returned by a comparison operator.
+ * @param x Elements to select where the mask is set.
+ * @param y Elements to select where the mask is not set.
+ */
+BI_FORCE_INLINE inline sse_double mask_select(const sse_double mask,
+    const sse_double x, const sse_double y) {
+  sse_double res;
+  res.packed = _mm_or_pd(_mm_and_pd(mask.packed, x.packed), _mm_andnot_pd(mask.packed, y.packed));
+  return res;
+}
+
+/**
+ * Is any element of a mask set?
+ */
+BI_FORCE_INLINE inline bool mask_any(const sse_double mask) {
+  return _mm_movemask_pd(mask.packed) != 0;
+}
+
 }
 
 #endif
@@ -81,6 +81,7 @@ union sse_float {
 
   sse_float& operator=(const float& o) {
     packed = _mm_set1_ps(o);
+    return *this;
   }
 };
 
@@ -372,6 +373,31 @@ BI_FORCE_INLINE inline float max_reduce(const sse_float x) {
   return bi::max(bi::max(x.unpacked.a, x.unpacked.b), bi::max(x.unpacked.c, x.unpacked.d));
 }
 
+BI_FORCE_INLINE inline float min_reduce(const sse_float x) {
+  return bi::min(bi::min(x.unpacked.a, x.unpacked.b), bi::min(x.unpacked.c, x.unpacked.d));
+}
+
+/**
+ * Select elements by mask.
+ *
+ * @param mask Mask, as returned by a comparison operator.
+ * @param x Elements to select where the mask is set.
+ * @param y Elements to select where the mask is not set.
+ */
+BI_FORCE_INLINE inline sse_float mask_select(const sse_float mask,
+    const sse_float x, const sse_float y) {
+  sse_float res;
+  res.packed = _mm_or_ps(_mm_and_ps(mask.packed, x.packed), _mm_andnot_ps(mask.packed, y.packed));
+  return res;
+}
+
+/**
+ * Is any element of a mask set?
+ */
+BI_FORCE_INLINE inline bool mask_any(const sse_float mask) {
+  return _mm_movemask_ps(mask.packed) != 0;
+}
+
 }
 
 #endif
@@ -0,0 +1,146 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_ODE_RK43LANEINTEGRATORSSE_HPP
+#define BI_SSE_ODE_RK43LANEINTEGRATORSSE_HPP
+
+namespace bi {
+/**
+ * @copydoc RK43Integrator
+ *
+ * Per-lane step size control, see DOPRI5LaneIntegratorSSE.
+ */
+template<class B, class S, class T1>
+class RK43LaneIntegratorSSE {
+public:
+  /**
+   * @copydoc RK43Integrator::integrate()
+   */
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
+#include "../../host/ode/RK43VisitorHost.hpp"
+#include "../../host/ode/IntegratorConstants.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+
+template<class B, class S, class T1>
+void bi::RK43LaneIntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::RK43LaneIntegratorSSE<B,S,T1>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
+  typedef typename temp_host_vector<simd_real>::type vector_type;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef RK43VisitorHost<B,S,S,simd_real,PX,simd_real> Visitor;
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+  const int chunk = h_ode_chunk(P, BI_SIMD_SIZE);
+
+  vector_type r1(N), r2(N), err(N), old(N);
+  simd_real t, h, hnext, e, e2, logfacold, logfac11, fac, hacc, hrej;
+  simd_real end, zero, one, accept, active;
+  int n, id, p;
+  PX pax;
+
+  end = t2;
+  zero = BI_REAL(0.0);
+  one = BI_REAL(1.0);
+
+  #pragma omp for schedule(dynamic, chunk)
+  for (p = 0; p < P; p += BI_SIMD_SIZE) {
+    t = t1;
+    h = sse_host_step(s, p);
+    h = bi::mask_select(h > zero, h, h_h0*one);
+    hnext = h;
+    logfacold = bi::log(BI_REAL(1.0e-4));
+    active = t < end;
+    n = 0;
+    sse_host_load<B,S>(s, p, old);
+    r1 = old;
+
+    /* integrate */
+    while (bi::mask_any(active) && n < h_nsteps) {
+      /* clip steps to end of interval, finished lanes get zero step */
+      hnext = bi::mask_select(active, h, hnext);
+      h = bi::mask_select(t + BI_REAL(1.01)*h - end > zero, end - t, h);
+      h = bi::mask_select(active, h, zero);
+
+      /* stages */
+      Visitor::stage1(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s, p, r1);
+
+      Visitor::stage2(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s, p, r2);
+
+      Visitor::stage3(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s, p, r1);
+
+      Visitor::stage4(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+      sse_host_store<B,S>(s, p, r2);
+
+      Visitor::stage5(t, h, s, p, pax, r1.buf(), r2.buf(), err.buf());
+
+      /* error of each trajectory */
+      e2 = BI_REAL(0.0);
+      for (id = 0; id < N; ++id) {
+        e = err(id)*h/(bi::max(bi::abs(old(id)), bi::abs(r1(id)))*h_rtoler + h_atoler);
+        e2 += e*e;
+      }
+      e2 = e2/BI_REAL(N);
+
+      /* accept/reject per lane */
+      accept = e2 <= one;
+      t = bi::mask_select(accept, t + h, t);
+      for (id = 0; id < N; ++id) {
+        r1(id) = bi::mask_select(accept, r1(id), old(id));
+        old(id) = r1(id);
+      }
+      sse_host_store<B,S>(s, p, r1);
+      active = t < end;
+
+      /* compute next step size per lane */
+      logfac11 = h_expo*bi::log(e2);
+      hrej = h*bi::max(h_facl*one, bi::exp(h_logsafe - logfac11));
+      fac = bi::exp(h_beta*logfacold + h_logsafe - logfac11); // Lund-stabilization
+      fac = bi::min(h_facr*one, bi::max(h_facl*one, fac)); // bound
+      hacc = h*fac;
+      h = bi::mask_select(accept, hacc, hrej);
+      logfacold = bi::mask_select(accept, BI_REAL(0.5)*bi::log(bi::max(e2, BI_REAL(1.0e-8)*one)), logfacold);
+
+      ++n;
+    }
+
+    /* keep unclipped step sizes for next update */
+    sse_host_step(s, p) = hnext;
+  }
+}
+
+#endif
@@ -19,10 +19,17 @@ public:
    * @copydoc RK4Integrator::integrate()
    */
   static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
 };
 }
 
 #include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../host/ode/RK4VisitorHost.hpp"
 #include "../../host/ode/IntegratorConstants.hpp"
 #include "../../state/Pa.hpp"
@@ -35,53 +42,63 @@ void bi::RK4IntegratorSSE<B,S,T1>::update(const T1 t1, const T1 t2,
   /* pre-condition */
   BI_ASSERT(t1 < t2);
 
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S, class T1>
+void bi::RK4IntegratorSSE<B,S,T1>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
   typedef typename temp_host_vector<simd_real>::type vector_type;
   typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
   typedef RK4VisitorHost<B,S,S,real,PX,simd_real> Visitor;
   static const int N = block_size<S>::value;
   const int P = s.size();
 
-  #pragma omp parallel
-  {
-    vector_type x0(N), x1(N), x2(N), x3(N), x4(N);
-    real t, h;
-    int p;
-    PX pax;
+  vector_type x0(N), x1(N), x2(N), x3(N), x4(N);
+  real t, h;
+  int p;
+  PX pax;
 
-    #pragma omp for
-    for (p = 0; p < P; p += BI_SIMD_SIZE) {
-      t = t1;
-      h = h_h0;
+  #pragma omp for
+  for (p = 0; p < P; p += BI_SIMD_SIZE) {
+    t = t1;
+    h = h_h0;
 
-      /* integrate */
-      while (t < t2) {
-        if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
-          // step size too small
-        }
-        if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
-          h = t2 - t;
-          if (h <= BI_REAL(0.0)) {
-            t = t2;
-            break;
-          }
+    /* integrate */
+    while (t < t2) {
+      if (BI_REAL(0.1)*bi::abs(h) <= bi::abs(t)*h_uround) {
+        // step size too small
+      }
+      if (t + BI_REAL(1.01)*h - t2 > BI_REAL(0.0)) {
+        h = t2 - t;
+        if (h <= BI_REAL(0.0)) {
+          t = t2;
+          break;
         }
-        sse_host_load<B,S>(s, p, x0);
+      }
+      sse_host_load<B,S>(s, p, x0);
 
-        /* stages */
-        Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf());
-        sse_host_store<B,S>(s, p, x1);
+      /* stages */
+      Visitor::stage1(t, h, s, p, pax, x0.buf(), x1.buf(), x2.buf(), x3.buf(), x4.buf());
+      sse_host_store<B,S>(s, p, x1);
 
-        Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf());
-        sse_host_store<B,S>(s, p, x2);
+      Visitor::stage2(t, h, s, p, pax, x0.buf(), x2.buf(), x3.buf(), x4.buf());
+      sse_host_store<B,S>(s, p, x2);
 
-        Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf());
-        sse_host_store<B,S>(s, p, x3);
+      Visitor::stage3(t, h, s, p, pax, x0.buf(), x3.buf(), x4.buf());
+      sse_host_store<B,S>(s, p, x3);
 
-        Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf());
-        sse_host_store<B,S>(s, p, x4);
+      Visitor::stage4(t, h, s, p, pax, x0.buf(), x4.buf());
+      sse_host_store<B,S>(s, p, x4);
 
-        t += h;
-      }
+      t += h;
     }
   }
 }
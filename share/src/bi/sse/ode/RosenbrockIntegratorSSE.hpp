@@ -0,0 +1,261 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_ODE_ROSENBROCKINTEGRATORSSE_HPP
+#define BI_SSE_ODE_ROSENBROCKINTEGRATORSSE_HPP
+
+namespace bi {
+/**
+ * @copydoc RosenbrockIntegratorHost
+ *
+ * Per-lane step size control, see DOPRI5LaneIntegratorSSE. Stiff
+ * trajectories of the same SIMD vector may take very different step sizes,
+ * so there is no variant with a shared step size. Row interchanges for
+ * pivoting are also made per lane.
+ */
+template<class B, class S, class X, class T1>
+class RosenbrockIntegratorSSE {
+public:
+  /**
+   * @copydoc RosenbrockIntegrator::integrate()
+   */
+  static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Integrate, sharing trajectories among the threads of the current team.
+   */
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+  /**
+   * @copydoc RosenbrockIntegratorHost::factor()
+   */
+  static void factor(const simd_real h, const simd_real* J, simd_real* A,
+      simd_real* piv);
+
+  /**
+   * @copydoc RosenbrockIntegratorHost::solve()
+   */
+  static void solve(const simd_real* A, const simd_real* piv,
+      simd_real* b);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
+#include "../../host/ode/RosenbrockVisitorHost.hpp"
+#include "../../host/ode/IntegratorConstants.hpp"
+#include "../../ode/RosenbrockStage.hpp"
+#include "../../state/Pa.hpp"
+#include "../../typelist/front.hpp"
+#include "../../typelist/pop_front.hpp"
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorSSE<B,S,X,T1>::update(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 < t2);
+
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorSSE<B,S,X,T1>::updateTeam(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  typedef typename temp_host_vector<simd_real>::type vector_type;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef RosenbrockVisitorHost<B,S,S,simd_real,PX,simd_real> Visitor;
+  typedef RosenbrockStage<simd_real,simd_real> stage;
+  static const int N = block_size<S>::value;
+  const int P = s.size();
+  const int chunk = h_ode_chunk(P, BI_SIMD_SIZE);
+
+  vector_type x0(N), x1(N), f0(N), f(N), k1(N), k2(N), k3(N), err(N),
+      J(N*N), A(N*N), piv(N);
+  simd_real t, h, hnext, e, e2, fac;
+  simd_real end, zero, one, accept, active, stale;
+  int n, id, p;
+  PX pax;
+
+  end = t2;
+  zero = BI_REAL(0.0);
+  one = BI_REAL(1.0);
+
+  #pragma omp for schedule(dynamic, chunk)
+  for (p = 0; p < P; p += BI_SIMD_SIZE) {
+    t = t1;
+    h = sse_host_step(s, p);
+    h = bi::mask_select(h > zero, h, h_h0*one);
+    hnext = h;
+    active = t < end;
+    stale = active;
+    n = 0;
+    sse_host_load<B,S>(s, p, x0);
+
+    /* integrate */
+    while (bi::mask_any(active) && n < h_nsteps) {
+      /* clip steps to end of interval, finished lanes keep a nonzero step
+       * so that the iteration matrix remains finite, but their results
+       * are discarded */
+      hnext = bi::mask_select(active, h, hnext);
+      h = bi::mask_select(t + BI_REAL(1.01)*h - end > zero, end - t, h);
+      h = bi::mask_select(active, h, hnext);
+
+      /* derivatives and Jacobian at start of step, for lanes that
+       * accepted their last step, kept over rejections */
+      if (bi::mask_any(stale)) {
+        Visitor::dfdt(t, s, p, pax, f.buf());
+        for (id = 0; id < N; ++id) {
+          f0(id) = bi::mask_select(stale, f(id), f0(id));
+        }
+        A.clear();
+        X::jacobian(t, s, p, pax, A.buf());
+        for (id = 0; id < N*N; ++id) {
+          J(id) = bi::mask_select(stale, A(id), J(id));
+        }
+      }
+      factor(h, J.buf(), A.buf(), piv.buf());
+
+      /* stages */
+      k1 = f0;
+      solve(A.buf(), piv.buf(), k1.buf());
+      for (id = 0; id < N; ++id) {
+        stage::stage1(x0(id), k1(id), x1(id));
+      }
+      sse_host_store<B,S>(s, p, x1);
+
+      Visitor::dfdt(stage::time2(t, h), s, p, pax, f.buf());
+      for (id = 0; id < N; ++id) {
+        stage::stage2(h, f(id), k1(id), k2(id));
+      }
+      solve(A.buf(), piv.buf(), k2.buf());
+
+      for (id = 0; id < N; ++id) {
+        stage::stage3(h, f(id), k1(id), k2(id), k3(id));
+      }
+      solve(A.buf(), piv.buf(), k3.buf());
+
+      /* error of each trajectory */
+      e2 = BI_REAL(0.0);
+      for (id = 0; id < N; ++id) {
+        stage::stageErr(x0(id), k1(id), k2(id), k3(id), x1(id), err(id));
+        e = err(id)/(bi::max(bi::abs(x0(id)), bi::abs(x1(id)))*h_rtoler + h_atoler);
+        e2 += e*e;
+      }
+      e2 = e2/BI_REAL(N);
+
+      /* accept/reject per lane */
+      accept = bi::mask_select(active, e2 <= one, zero);
+      t = bi::mask_select(accept, t + h, t);
+      stale = accept;
+      for (id = 0; id < N; ++id) {
+        x0(id) = bi::mask_select(accept, x1(id), x0(id));
+      }
+      sse_host_store<B,S>(s, p, x0);
+
+      /* compute next step size per lane, error is of order 3 in h */
+      fac = bi::exp(h_logsafe - BI_REAL(1.0/6.0)*bi::log(e2));
+      fac = bi::mask_select(fac > zero, fac, h_facl*one); // NaN error
+      fac = bi::min(h_facr*one, bi::max(h_facl*one, fac)); // bound
+      h = bi::mask_select(active, h*fac, hnext);
+      active = t < end;
+
+      ++n;
+    }
+
+    /* keep unclipped step sizes for next update */
+    sse_host_step(s, p) = hnext;
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorSSE<B,S,X,T1>::factor(const simd_real h,
+    const simd_real* J, simd_real* A, simd_real* piv) {
+  typedef RosenbrockStage<simd_real,simd_real> stage;
+  static const int N = block_size<S>::value;
+
+  const simd_real d = stage::shift(h);
+  simd_real a, amax, ik, swap;
+  int i, j, k;
+
+  for (j = 0; j < N; ++j) {
+    for (i = 0; i < N; ++i) {
+      A[i + N*j] = -J[i + N*j];
+    }
+    A[j + N*j] += d;
+  }
+
+  for (k = 0; k < N; ++k) {
+    /* pivot, per lane */
+    piv[k] = BI_REAL(k);
+    amax = bi::abs(A[k + N*k]);
+    for (i = k + 1; i < N; ++i) {
+      swap = bi::abs(A[i + N*k]) > amax;
+      amax = bi::mask_select(swap, bi::abs(A[i + N*k]), amax);
+      ik = BI_REAL(i);
+      piv[k] = bi::mask_select(swap, ik, piv[k]);
+    }
+    for (i = k + 1; i < N; ++i) {
+      ik = BI_REAL(i);
+      swap = piv[k] == ik;
+      if (bi::mask_any(swap)) {
+        for (j = 0; j < N; ++j) {
+          a = A[k + N*j];
+          A[k + N*j] = bi::mask_select(swap, A[i + N*j], a);
+          A[i + N*j] = bi::mask_select(swap, a, A[i + N*j]);
+        }
+      }
+    }
+
+    /* eliminate */
+    for (i = k + 1; i < N; ++i) {
+      A[i + N*k] /= A[k + N*k];
+      for (j = k + 1; j < N; ++j) {
+        A[i + N*j] -= A[i + N*k]*A[k + N*j];
+      }
+    }
+  }
+}
+
+template<class B, class S, class X, class T1>
+void bi::RosenbrockIntegratorSSE<B,S,X,T1>::solve(const simd_real* A,
+    const simd_real* piv, simd_real* b) {
+  static const int N = block_size<S>::value;
+
+  simd_real a, ik, swap;
+  int i, k;
+
+  for (k = 0; k < N; ++k) {
+    for (i = k + 1; i < N; ++i) {
+      ik = BI_REAL(i);
+      swap = piv[k] == ik;
+      a = b[k];
+      b[k] = bi::mask_select(swap, b[i], a);
+      b[i] = bi::mask_select(swap, a, b[i]);
+    }
+  }
+  for (k = 0; k < N; ++k) {
+    for (i = k + 1; i < N; ++i) {
+      b[i] -= A[i + N*k]*b[k];
+    }
+  }
+  for (k = N - 1; k >= 0; --k) {
+    b[k] /= A[k + N*k];
+    for (i = 0; i < k; ++i) {
+      b[i] -= A[i + N*k]*b[k];
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,415 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_RANDOM_RANDOMSSE_HPP
+#define BI_SSE_RANDOM_RANDOMSSE_HPP
+
+#include "../math/scalar.hpp"
+#include "../../host/random/RandomHost.hpp"
+
+namespace bi {
+class RngSSE;
+
+/**
+ * Implementation of Random on host, using SSE instructions.
+ *
+ * Uniforms, Gaussians, gammas and betas are generated a SIMD vector at a
+ * time. Raw variates are drawn from a PhiloxHost stream per vector, then
+ * transformed with vector arithmetic. Gaussians use the Box-Muller
+ * transform, with the logarithm and the sine and cosine computed by
+ * polynomials over reduced ranges, rather than element by element as in the
+ * SSE math functions. Gammas use the method of @ref Marsaglia2000
+ * "Marsaglia & Tsang (2000)", with all lanes proposing together until each
+ * has accepted, and betas are built from pairs of gammas. The remaining
+ * distributions defer to RandomHost.
+ *
+ * Variates differ from those of RandomHost, but are likewise the same for
+ * any number of threads.
+ */
+struct RandomSSE : public RandomHost {
+  /**
+   * @copydoc Random::uniforms
+   */
+  template<class V1>
+  static void uniforms(Random& rng, V1 x,
+      const typename V1::value_type lower = 0.0,
+      const typename V1::value_type upper = 1.0);
+
+  /**
+   * @copydoc Random::gaussians
+   */
+  template<class V1>
+  static void gaussians(Random& rng, V1 x, const typename V1::value_type mu =
+      0.0, const typename V1::value_type sigma = 1.0);
+
+  /**
+   * @copydoc Random::gammas
+   */
+  template<class V1>
+  static void gammas(Random& rng, V1 x, const typename V1::value_type alpha =
+      1.0, const typename V1::value_type beta = 1.0);
+
+  /**
+   * @copydoc Random::betas
+   */
+  template<class V1>
+  static void betas(Random& rng, V1 x, const typename V1::value_type alpha =
+      1.0, const typename V1::value_type beta = 1.0);
+
+private:
+  friend class RngSSE;
+
+  /**
+   * Draw uniform variate on \f$(0,1)\f$, with full precision of #real.
+   *
+   * @param rng Random number generator.
+   */
+  static real uniform(RngHost::rng_type& rng);
+
+  /**
+   * Draw vector of uniform variates on \f$(0,1)\f$.
+   *
+   * @param rng Random number generator.
+   * @param[out] u Variates.
+   */
+  static void uniforms(RngHost::rng_type& rng, simd_real& u);
+
+  /**
+   * Draw two vectors of standard Gaussian variates, by Box-Muller.
+   *
+   * @param rng Random number generator.
+   * @param[out] y1 Variates.
+   * @param[out] y2 Variates.
+   */
+  static void gaussians(RngHost::rng_type& rng, simd_real& y1,
+      simd_real& y2);
+
+  /**
+   * Draw vector of gamma variates with unit scale.
+   *
+   * @param rng Random number generator.
+   * @param alpha Shape.
+   * @param[out] y Variates.
+   */
+  static void gammas(RngHost::rng_type& rng, const real alpha,
+      simd_real& y);
+
+  /**
+   * Natural logarithm.
+   *
+   * @param m Mantissa, in \f$[1/\sqrt{2},\sqrt{2})\f$.
+   * @param e Exponent.
+   *
+   * @return \f$\ln(m2^e)\f$.
+   */
+  static simd_real log(const simd_real m, const simd_real e);
+
+  /**
+   * Sine and cosine.
+   *
+   * @param phi Angle, in \f$[0,\pi/4]\f$.
+   * @param[out] sin Sine of @p phi.
+   * @param[out] cos Cosine of @p phi.
+   */
+  static void sincos(const simd_real phi, simd_real& sin, simd_real& cos);
+};
+}
+
+#include "../../random/Random.hpp"
+
+#include "boost/type_traits/is_same.hpp"
+
+template<class V1>
+void bi::RandomSSE::uniforms(Random& rng, V1 x,
+    const typename V1::value_type lower,
+    const typename V1::value_type upper) {
+  /* pre-condition */
+  BI_ASSERT(upper >= lower);
+
+  static const int W = BI_SIMD_SIZE;
+
+  if (!boost::is_same<typename V1::value_type,real>::value) {
+    RandomHost::uniforms(rng, x, lower, upper);
+  } else {
+    const boost::uint64_t s = rng.nextHostStream();
+    const int N = x.size();
+
+    #pragma omp parallel
+    {
+      simd_real u, y;
+      int c, i, j;
+
+      #pragma omp for schedule(static)
+      for (c = 0; c < (N + W - 1)/W; ++c) {
+        RngHost rng1(rng.getHostStream(s, c));
+        uniforms(rng1.rng, u);
+        y = lower + (upper - lower)*u;
+        for (i = 0, j = c*W; i < W && j < N; ++i, ++j) {
+          x(j) = reinterpret_cast<real*>(&y)[i];
+        }
+      }
+    }
+  }
+}
+
+template<class V1>
+void bi::RandomSSE::gaussians(Random& rng, V1 x,
+    const typename V1::value_type mu, const typename V1::value_type sigma) {
+  /* pre-condition */
+  BI_ASSERT(sigma >= 0.0);
+
+  static const int W = BI_SIMD_SIZE;
+
+  if (!boost::is_same<typename V1::value_type,real>::value) {
+    RandomHost::gaussians(rng, x, mu, sigma);
+  } else {
+    const boost::uint64_t s = rng.nextHostStream();
+    const int N = x.size();
+
+    #pragma omp parallel
+    {
+      simd_real y1, y2;
+      int c, i, j;
+
+      /* each vector of Box-Muller pairs fills 2*W elements, the first W
+       * from the cosines and the second W from the sines */
+      #pragma omp for schedule(static)
+      for (c = 0; c < (N + 2*W - 1)/(2*W); ++c) {
+        RngHost rng1(rng.getHostStream(s, c));
+        gaussians(rng1.rng, y1, y2);
+        y1 = mu + sigma*y1;
+        y2 = mu + sigma*y2;
+
+        for (i = 0, j = 2*c*W; i < W && j < N; ++i, ++j) {
+          x(j) = reinterpret_cast<real*>(&y1)[i];
+        }
+        for (i = 0, j = 2*c*W + W; i < W && j < N; ++i, ++j) {
+          x(j) = reinterpret_cast<real*>(&y2)[i];
+        }
+      }
+    }
+  }
+}
+
+template<class V1>
+void bi::RandomSSE::gammas(Random& rng, V1 x,
+    const typename V1::value_type alpha, const typename V1::value_type beta) {
+  /* pre-condition */
+  BI_ASSERT(alpha > 0.0 && beta > 0.0);
+
+  static const int W = BI_SIMD_SIZE;
+
+  if (!boost::is_same<typename V1::value_type,real>::value) {
+    RandomHost::gammas(rng, x, alpha, beta);
+  } else {
+    const boost::uint64_t s = rng.nextHostStream();
+    const int N = x.size();
+
+    #pragma omp parallel
+    {
+      simd_real y;
+      int c, i, j;
+
+      #pragma omp for schedule(static)
+      for (c = 0; c < (N + W - 1)/W; ++c) {
+        RngHost rng1(rng.getHostStream(s, c));
+        gammas(rng1.rng, alpha, y);
+        y = beta*y;
+
+        for (i = 0, j = c*W; i < W && j < N; ++i, ++j) {
+          x(j) = reinterpret_cast<real*>(&y)[i];
+        }
+      }
+    }
+  }
+}
+
+template<class V1>
+void bi::RandomSSE::betas(Random& rng, V1 x,
+    const typename V1::value_type alpha, const typename V1::value_type beta) {
+  /* pre-condition */
+  BI_ASSERT(alpha > 0.0 && beta > 0.0);
+
+  static const int W = BI_SIMD_SIZE;
+
+  if (!boost::is_same<typename V1::value_type,real>::value) {
+    RandomHost::betas(rng, x, alpha, beta);
+  } else {
+    const boost::uint64_t s = rng.nextHostStream();
+    const int N = x.size();
+
+    #pragma omp parallel
+    {
+      simd_real y1, y2;
+      int c, i, j;
+
+      #pragma omp for schedule(static)
+      for (c = 0; c < (N + W - 1)/W; ++c) {
+        RngHost rng1(rng.getHostStream(s, c));
+        gammas(rng1.rng, alpha, y1);
+        gammas(rng1.rng, beta, y2);
+        y1 = y1/(y1 + y2);
+
+        for (i = 0, j = c*W; i < W && j < N; ++i, ++j) {
+          x(j) = reinterpret_cast<real*>(&y1)[i];
+        }
+      }
+    }
+  }
+}
+
+inline real bi::RandomSSE::uniform(RngHost::rng_type& rng) {
+  #ifdef ENABLE_SINGLE
+  return static_cast<real>(((rng() >> 8) + 0.5)/16777216.0);
+  #else
+  const double a = rng() >> 5, b = rng() >> 6;
+  return (a*67108864.0 + b + 0.5)/9007199254740992.0;
+  #endif
+}
+
+inline void bi::RandomSSE::uniforms(RngHost::rng_type& rng, simd_real& u) {
+  for (int i = 0; i < BI_SIMD_SIZE; ++i) {
+    reinterpret_cast<real*>(&u)[i] = uniform(rng);
+  }
+}
+
+inline void bi::RandomSSE::gaussians(RngHost::rng_type& rng, simd_real& y1,
+    simd_real& y2) {
+  simd_real m, e, phi, swap, signc, signs, r, sn, cs, zero;
+  boost::uint32_t w, v;
+  real mi;
+  int i, ei;
+
+  zero = BI_REAL(0.0);
+
+  /* raw variates, lane by lane */
+  for (i = 0; i < BI_SIMD_SIZE; ++i) {
+    mi = std::frexp(uniform(rng), &ei);
+    if (mi < BI_REAL(0.70710678118654752440)) {
+      mi *= BI_REAL(2.0);
+      --ei;
+    }
+    reinterpret_cast<real*>(&m)[i] = mi;
+    reinterpret_cast<real*>(&e)[i] = ei;
+
+    /* the angle is uniform on the first octant, with three bits to
+     * reflect it uniformly onto the circle */
+    w = rng();
+    v = rng();
+    reinterpret_cast<real*>(&phi)[i] = BI_REAL(0.78539816339744830962)*
+        ((static_cast<double>(w & 0x1FFFFFFFu)*4294967296.0 + v + 0.5)/
+        2305843009213693952.0);
+    reinterpret_cast<real*>(&swap)[i] = (w & 0x20000000u) ? 1 : 0;
+    reinterpret_cast<real*>(&signc)[i] = (w & 0x40000000u) ? -1 : 1;
+    reinterpret_cast<real*>(&signs)[i] = (w & 0x80000000u) ? -1 : 1;
+  }
+
+  /* transform */
+  r = bi::sqrt(BI_REAL(-2.0)*log(m, e));
+  sincos(phi, sn, cs);
+  y1 = r*signc*bi::mask_select(swap > zero, sn, cs);
+  y2 = r*signs*bi::mask_select(swap > zero, cs, sn);
+}
+
+inline void bi::RandomSSE::gammas(RngHost::rng_type& rng, const real alpha,
+    simd_real& y) {
+  simd_real x, x2, v, u, scale, accept, pending, zero, one;
+  simd_real y1, y2;
+  bool cached = false;
+
+  const real d = (alpha < BI_REAL(1.0)) ? alpha + BI_REAL(2.0/3.0) :
+      alpha - BI_REAL(1.0/3.0);
+  const real c = BI_REAL(1.0)/bi::sqrt(BI_REAL(9.0)*d);
+
+  zero = BI_REAL(0.0);
+  one = BI_REAL(1.0);
+  pending = one > zero;
+  y = zero;
+
+  /* all lanes propose together, each keeping its first acceptance */
+  do {
+    if (!cached) {
+      gaussians(rng, y1, y2);
+      x = y1;
+    } else {
+      x = y2;
+    }
+    cached = !cached;
+    uniforms(rng, u);
+
+    v = one + c*x;
+    v = v*v*v;
+    x2 = x*x;
+
+    /* squeeze, then full test only where some lane needs it */
+    accept = u < one - BI_REAL(0.0331)*x2*x2;
+    if (bi::mask_any(bi::mask_select(accept, zero, pending))) {
+      accept = bi::mask_select(accept, accept, bi::log(u) < BI_REAL(0.5)*x2 +
+          d - d*v + d*bi::log(bi::max(v, zero)));
+    }
+    accept = bi::mask_select(v > zero, accept, zero);
+    accept = bi::mask_select(pending, accept, zero);
+
+    y = bi::mask_select(accept, d*v, y);
+    pending = bi::mask_select(accept, zero, pending);
+  } while (bi::mask_any(pending));
+
+  /* boost from alpha + 1 to alpha */
+  if (alpha < BI_REAL(1.0)) {
+    uniforms(rng, u);
+    scale = bi::pow(u, BI_REAL(1.0)/alpha);
+    y = y*scale;
+  }
+}
+
+inline bi::simd_real bi::RandomSSE::log(const simd_real m,
+    const simd_real e) {
+  /* series of 2*atanh(z) with z = (m - 1)/(m + 1), |z| < 0.172 */
+  simd_real z, z2, p;
+
+  z = (m - BI_REAL(1.0))/(m + BI_REAL(1.0));
+  z2 = z*z;
+  p = BI_REAL(1.0/21.0);
+  p = BI_REAL(1.0/19.0) + z2*p;
+  p = BI_REAL(1.0/17.0) + z2*p;
+  p = BI_REAL(1.0/15.0) + z2*p;
+  p = BI_REAL(1.0/13.0) + z2*p;
+  p = BI_REAL(1.0/11.0) + z2*p;
+  p = BI_REAL(1.0/9.0) + z2*p;
+  p = BI_REAL(1.0/7.0) + z2*p;
+  p = BI_REAL(1.0/5.0) + z2*p;
+  p = BI_REAL(1.0/3.0) + z2*p;
+  p = BI_REAL(1.0) + z2*p;
+
+  return BI_REAL(2.0)*z*p + BI_REAL(0.69314718055994530942)*e;
+}
+
+inline void bi::RandomSSE::sincos(const simd_real phi, simd_real& sin,
+    simd_real& cos) {
+  /* Taylor series, |phi| <= pi/4 */
+  simd_real phi2 = phi*phi;
+
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/210.0);
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/156.0)*sin;
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/110.0)*sin;
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/72.0)*sin;
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/42.0)*sin;
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/20.0)*sin;
+  sin = BI_REAL(1.0) - phi2*BI_REAL(1.0/6.0)*sin;
+  sin = phi*sin;
+
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/240.0);
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/182.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/132.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/90.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/56.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/30.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/12.0)*cos;
+  cos = BI_REAL(1.0) - phi2*BI_REAL(1.0/2.0)*cos;
+}
+
+#endif
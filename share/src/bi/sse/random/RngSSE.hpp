@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_RANDOM_RNGSSE_HPP
+#define BI_SSE_RANDOM_RNGSSE_HPP
+
+#include "RandomSSE.hpp"
+
+namespace bi {
+/**
+ * Pseudorandom number generator, on host, using SSE instructions.
+ *
+ * @ingroup math_rng
+ *
+ * Draws a SIMD vector of variates at a time, one per lane, for the SSE
+ * sampler updaters, where each lane is a separate trajectory. Shares its
+ * arithmetic with RandomSSE. Box-Muller produces Gaussians in pairs of
+ * vectors, so the second of each pair is kept for the next call.
+ */
+class RngSSE {
+public:
+  /**
+   * Constructor.
+   *
+   * @param rng Host random number generator, usually a stream from
+   * Random::getHostStream.
+   */
+  RngSSE(const RngHost& rng);
+
+  /**
+   * @copydoc Random::uniform
+   */
+  simd_real uniform(const simd_real lower, const simd_real upper);
+
+  /**
+   * @copydoc Random::gaussian
+   */
+  simd_real gaussian(const simd_real mu, const simd_real sigma);
+
+  /**
+   * Random number generator.
+   */
+  RngHost::rng_type rng;
+
+private:
+  /**
+   * Second vector of the last Box-Muller pair.
+   */
+  simd_real y2;
+
+  /**
+   * Is #y2 unused?
+   */
+  bool cached;
+};
+}
+
+inline bi::RngSSE::RngSSE(const RngHost& rng) :
+    rng(rng.rng), cached(false) {
+  //
+}
+
+inline bi::simd_real bi::RngSSE::uniform(const simd_real lower,
+    const simd_real upper) {
+  simd_real u;
+  RandomSSE::uniforms(rng, u);
+
+  return lower + (upper - lower)*u;
+}
+
+inline bi::simd_real bi::RngSSE::gaussian(const simd_real mu,
+    const simd_real sigma) {
+  simd_real y1;
+  if (cached) {
+    y1 = y2;
+  } else {
+    RandomSSE::gaussians(rng, y1, y2);
+  }
+  cached = !cached;
+
+  return mu + sigma*y1;
+}
+
+#endif
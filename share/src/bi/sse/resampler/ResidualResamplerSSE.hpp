@@ -0,0 +1,105 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_RESAMPLER_RESIDUALRESAMPLERSSE_HPP
+#define BI_SSE_RESAMPLER_RESIDUALRESAMPLERSSE_HPP
+
+#include "../math/scalar.hpp"
+#include "../../primitive/vector_primitive.hpp"
+#include "../../math/misc.hpp"
+#include "../../misc/omp.hpp"
+
+#include <vector>
+
+template<class V1, class V2, class V3>
+int bi::ResidualResamplerSSE::deterministic(const V1 lws, V2 os, V3 rs,
+    const int n) throw (ParticleFilterDegeneratedException) {
+  /* pre-conditions */
+  BI_ASSERT(lws.size() == os.size());
+  BI_ASSERT(lws.size() == rs.size());
+  BI_ASSERT(lws.inc() == 1 && rs.inc() == 1);
+  BI_ASSERT(lws.size() % BI_SIMD_SIZE == 0);
+  BI_ASSERT(simd_aligned(lws.buf()) && simd_aligned(rs.buf()));
+
+  const int P = lws.size();
+  const real mx = max_reduce(lws);
+  std::vector<real> Ws(bi_omp_max_threads, 0.0);
+  std::vector<int> ms(bi_omp_max_threads, 0);
+  real W = 0.0;
+  int m = 0, t;
+
+  if (!is_finite(mx)) {
+    throw ParticleFilterDegeneratedException();
+  }
+
+  #pragma omp parallel
+  {
+    simd_real mx1, W1;
+    const simd_real* lws1;
+    simd_real* rs1;
+    real W2 = 0.0;
+    int i, j;
+
+    mx1 = mx;
+    W1 = 0.0;
+
+    #pragma omp for
+    for (i = 0; i < P; i += BI_SIMD_SIZE) {
+      lws1 = reinterpret_cast<const simd_real*>(&lws(i));
+      rs1 = reinterpret_cast<simd_real*>(&rs(i));
+      *rs1 = bi::exp(*lws1 - mx1);
+      W1 += *rs1;
+    }
+    for (j = 0; j < BI_SIMD_SIZE; ++j) {
+      W2 += reinterpret_cast<real*>(&W1)[j];
+    }
+
+    Ws[bi_omp_tid] = W2;
+  }
+
+  /* combine in thread order, so that the result is reproducible */
+  for (t = 0; t < bi_omp_max_threads; ++t) {
+    W += Ws[t];
+  }
+
+  const real c = n/W;
+
+  #pragma omp parallel
+  {
+    simd_real c1, x, o;
+    simd_real* rs1;
+    int i, j, m1 = 0, o1;
+
+    c1 = c;
+
+    #pragma omp for
+    for (i = 0; i < P; i += BI_SIMD_SIZE) {
+      rs1 = reinterpret_cast<simd_real*>(&rs(i));
+      x = c1*(*rs1);
+      o = bi::floor(x);
+      *rs1 = x - o;
+      for (j = 0; j < BI_SIMD_SIZE; ++j) {
+        o1 = static_cast<int>(reinterpret_cast<real*>(&o)[j]);
+        os(i + j) = o1;
+        m1 += o1;
+      }
+    }
+
+    ms[bi_omp_tid] = m1;
+  }
+  for (t = 0; t < bi_omp_max_threads; ++t) {
+    m += ms[t];
+  }
+
+  if (m > n) {
+    overshoot(os, m - n);
+    m = n;
+  }
+  return n - m;
+}
+
+#endif
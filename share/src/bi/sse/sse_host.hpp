@@ -192,6 +192,19 @@ void sse_host_load(State<B,ON_HOST>& s, const int p, V1 x);
 template<class B, class S, class V1>
 void sse_host_store(State<B,ON_HOST>& s, const int p, const V1 x);
 
+/**
+ * Fetch step sizes of adaptive ODE integrators.
+ *
+ * @tparam B Model type.
+ *
+ * @param s State.
+ * @param p Trajectory id.
+ *
+ * @return Step sizes, see State::getStep().
+ */
+template<class B>
+simd_real& sse_host_step(State<B,ON_HOST>& s, const int p);
+
 }
 
 #include "sse_host_load_visitor.hpp"
@@ -277,4 +290,9 @@ inline void bi::sse_host_store(State<B,ON_HOST>& s, const int p, const V1 x) {
   sse_host_store_visitor<B,S,S>::accept(s, p, x);
 }
 
+template<class B>
+inline bi::simd_real& bi::sse_host_step(State<B,ON_HOST>& s, const int p) {
+  return *reinterpret_cast<simd_real*>(&s.getStep(p));
+}
+
 #endif
@@ -0,0 +1,71 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_DYNAMICLOGDENSITYSSE_HPP
+#define BI_SSE_UPDATER_DYNAMICLOGDENSITYSSE_HPP
+
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Dynamic log-density evaluator, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ */
+template<class B, class S>
+class DynamicLogDensitySSE {
+public:
+  /**
+   * @copydoc DynamicLogDensity::logDensities(const T1, const T1, State<B,ON_HOST>&, V1)
+   */
+  template<class T1, class V1>
+  static void logDensities(const T1 t1, const T1 t2, State<B,ON_HOST>& s,
+      V1 lp);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../host/updater/DynamicLogDensityVisitorHost.hpp"
+#include "../../host/updater/DynamicLogDensityMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class T1, class V1>
+void bi::DynamicLogDensitySSE<B,S>::logDensities(const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s, V1 lp) {
+  /* pre-conditions */
+  BI_ASSERT(lp.inc() == 1);
+  BI_ASSERT(t1 <= t2);
+
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef DynamicLogDensityMatrixVisitorHost<B,S,PX,OX> MatrixVisitor;
+  typedef DynamicLogDensityVisitorHost<B,S,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  #pragma omp parallel
+  {
+    int p;
+    PX pax;
+    OX x;
+    simd_real* lp1;
+
+    #pragma omp for
+    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+      lp1 = reinterpret_cast<simd_real*>(&lp(p));
+      Visitor::accept(t1, t2, s, p, pax, x, *lp1);
+    }
+  }
+}
+
+#endif
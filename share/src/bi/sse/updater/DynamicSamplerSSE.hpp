@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_SSE_UPDATER_DYNAMICSAMPLERSSE_HPP
+#define BI_SSE_UPDATER_DYNAMICSAMPLERSSE_HPP
+
+#include "../../random/Random.hpp"
+#include "../../state/State.hpp"
+
+namespace bi {
+/**
+ * Dynamic sampler, using SSE instructions.
+ *
+ * @ingroup method_updater
+ *
+ * @tparam B Model type.
+ * @tparam S Action type list.
+ *
+ * Variates are drawn a SIMD vector at a time with RngSSE, from one stream
+ * per vector of trajectories, so differ from those of DynamicSamplerHost.
+ */
+template<class B, class S>
+class DynamicSamplerSSE {
+public:
+  /**
+   * @copydoc DynamicSampler::samples(Random&, const T1, const T1, State<B,ON_HOST>&)
+   */
+  template<class T1>
+  static void samples(Random& rng, const T1 t1, const T1 t2,
+      State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Sample, sharing trajectories among the threads of the current team.
+   */
+  template<class T1>
+  static void samplesTeam(Random& rng, const T1 t1, const T1 t2,
+      State<B,ON_HOST>& s);
+};
+}
+
+#include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
+#include "../random/RngSSE.hpp"
+#include "../../host/updater/DynamicSamplerVisitorHost.hpp"
+#include "../../host/updater/DynamicSamplerMatrixVisitorHost.hpp"
+#include "../../state/Pa.hpp"
+#include "../../state/Ou.hpp"
+#include "../../traits/block_traits.hpp"
+
+template<class B, class S>
+template<class T1>
+void bi::DynamicSamplerSSE<B,S>::samples(Random& rng, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  /* pre-condition */
+  BI_ASSERT(t1 <= t2);
+
+  if (bi_omp_team) {
+    samplesTeam(rng, t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      samplesTeam(rng, t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S>
+template<class T1>
+void bi::DynamicSamplerSSE<B,S>::samplesTeam(Random& rng, const T1 t1,
+    const T1 t2, State<B,ON_HOST>& s) {
+  typedef RngSSE R1;
+  typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
+  typedef Ou<ON_HOST,B,sse_host> OX;
+  typedef DynamicSamplerMatrixVisitorHost<B,S,R1,PX,OX> MatrixVisitor;
+  typedef DynamicSamplerVisitorHost<B,S,R1,PX,OX> ElementVisitor;
+  typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
+      ElementVisitor>::type Visitor;
+
+  PX pax;
+  OX x;
+  boost::uint64_t st;
+  int p;
+
+  /* one stream for the whole team */
+  #pragma omp single copyprivate(st)
+  st = rng.nextHostStream();
+
+  #pragma omp for
+  for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+    /* own stream per vector, for results independent of thread count and
+     * tiling */
+    R1 rng1(rng.getHostStream(st, (s.start() + p)/BI_SIMD_SIZE));
+    Visitor::accept(rng1, t1, t2, s, p, pax, x);
+  }
+}
+
+#endif
@@ -25,11 +25,19 @@ public:
    */
   template<class T1>
   static void update(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
+
+private:
+  /**
+   * Update, sharing trajectories among the threads of the current team.
+   */
+  template<class T1>
+  static void updateTeam(const T1 t1, const T1 t2, State<B,ON_HOST>& s);
 };
 
 }
 
 #include "../sse_host.hpp"
+#include "../../misc/omp.hpp"
 #include "../../host/updater/DynamicUpdaterVisitorHost.hpp"
 #include "../../host/updater/DynamicUpdaterMatrixVisitorHost.hpp"
 #include "../../state/Pa.hpp"
@@ -43,6 +51,20 @@ void bi::DynamicUpdaterSSE<B,S>::update(const T1 t1, const T1 t2,
   /* pre-condition */
   BI_ASSERT(t1 <= t2);
 
+  if (bi_omp_team) {
+    updateTeam(t1, t2, s);
+  } else {
+    #pragma omp parallel
+    {
+      updateTeam(t1, t2, s);
+    }
+  }
+}
+
+template<class B, class S>
+template<class T1>
+void bi::DynamicUpdaterSSE<B,S>::updateTeam(const T1 t1, const T1 t2,
+    State<B,ON_HOST>& s) {
   typedef Pa<ON_HOST,B,host,host,sse_host,sse_host> PX;
   typedef Ou<ON_HOST,B,sse_host> OX;
   typedef DynamicUpdaterMatrixVisitorHost<B,S,T1,PX,OX> MatrixVisitor;
@@ -50,16 +72,13 @@ void bi::DynamicUpdaterSSE<B,S>::update(const T1 t1, const T1 t2,
   typedef typename boost::mpl::if_c<block_is_matrix<S>::value,MatrixVisitor,
       ElementVisitor>::type Visitor;
 
-  #pragma omp parallel
-  {
-    int p;
-    PX pax;
-    OX x;
+  PX pax;
+  OX x;
+  int p;
 
-    #pragma omp for
-    for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
-      Visitor::accept(t1, t2, s, p, pax, x);
-    }
+  #pragma omp for
+  for (p = 0; p < s.size(); p += BI_SIMD_SIZE) {
+    Visitor::accept(t1, t2, s, p, pax, x);
   }
 }
 
@@ -0,0 +1,145 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_STATE_MARGINALDAMHSTATE_HPP
+#define BI_STATE_MARGINALDAMHSTATE_HPP
+
+#include "../state/SamplerState.hpp"
+
+namespace bi {
+/**
+ * State for MarginalDAMH.
+ *
+ * @ingroup state
+ *
+ * @tparam B Model type.
+ * @tparam L Location.
+ * @tparam S1 Filter state type.
+ * @tparam IO1 Filter cache type.
+ * @tparam S2 Surrogate filter state type.
+ * @tparam IO2 Surrogate filter cache type.
+ */
+template<class B, Location L, class S1, class IO1, class S2, class IO2>
+class MarginalDAMHState {
+public:
+  /**
+   * State type.
+   */
+  typedef SamplerState<B,L,S1,IO1> state_type;
+
+  /**
+   * Surrogate state type.
+   */
+  typedef SamplerState<B,L,S2,IO2> surrogate_state_type;
+
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param P Number of \f$x\f$-particles.
+   * @param T Number of time points.
+   */
+  MarginalDAMHState(B& m, const int P = 0, const int T = 0);
+
+  /**
+   * Shallow copy constructor.
+   */
+  MarginalDAMHState(const MarginalDAMHState<B,L,S1,IO1,S2,IO2>& o);
+
+  /**
+   * Assignment operator.
+   */
+  MarginalDAMHState& operator=(const MarginalDAMHState<B,L,S1,IO1,S2,IO2>& o);
+
+  /**
+   * Current state.
+   */
+  state_type theta1;
+
+  /**
+   * Proposed state.
+   */
+  state_type theta2;
+
+  /**
+   * Current state, under surrogate filter.
+   */
+  surrogate_state_type eta1;
+
+  /**
+   * Proposed state, under surrogate filter.
+   */
+  surrogate_state_type eta2;
+
+private:
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+template<class B, bi::Location L, class S1, class IO1, class S2, class IO2>
+bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>::MarginalDAMHState(B& m,
+    const int P, const int T) :
+    theta1(m, P, T), theta2(m, P, T), eta1(m, 1, T), eta2(m, 1, T) {
+  //
+}
+
+template<class B, bi::Location L, class S1, class IO1, class S2, class IO2>
+bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>::MarginalDAMHState(
+    const MarginalDAMHState<B,L,S1,IO1,S2,IO2>& o) :
+    theta1(o.theta1), theta2(o.theta2), eta1(o.eta1), eta2(o.eta2) {
+  //
+}
+
+template<class B, bi::Location L, class S1, class IO1, class S2, class IO2>
+bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>&
+    bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>::operator=(
+    const MarginalDAMHState<B,L,S1,IO1,S2,IO2>& o) {
+  theta1 = o.theta1;
+  theta2 = o.theta2;
+  eta1 = o.eta1;
+  eta2 = o.eta2;
+
+  return *this;
+}
+
+template<class B, bi::Location L, class S1, class IO1, class S2, class IO2>
+template<class Archive>
+void bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>::save(Archive& ar,
+    const unsigned version) const {
+  ar & theta1;
+  ar & theta2;
+  ar & eta1;
+  ar & eta2;
+}
+
+template<class B, bi::Location L, class S1, class IO1, class S2, class IO2>
+template<class Archive>
+void bi::MarginalDAMHState<B,L,S1,IO1,S2,IO2>::load(Archive& ar,
+    const unsigned version) {
+  ar & theta1;
+  ar & theta2;
+  ar & eta1;
+  ar & eta2;
+}
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @author Lawrence Murray <lawrence.murray@csiro.au>
+ * $Rev$
+ * $Date$
+ */
+#ifndef BI_STATE_MARGINALMHCHAINSSTATE_HPP
+#define BI_STATE_MARGINALMHCHAINSSTATE_HPP
+
+#include "MarginalMHState.hpp"
+#include "../buffer/MCMCBuffer.hpp"
+#include "../cache/MCMCCache.hpp"
+
+#include <vector>
+
+namespace bi {
+/**
+ * State for MarginalMHChains.
+ *
+ * @ingroup state
+ *
+ * @tparam B Model type.
+ * @tparam L Location.
+ * @tparam S1 Filter state type.
+ * @tparam IO1 Filter cache type.
+ */
+template<class B, Location L, class S1, class IO1>
+class MarginalMHChainsState {
+public:
+  static const Location location = L;
+  static const bool on_device = (L == ON_DEVICE);
+
+  /**
+   * Chain state type.
+   */
+  typedef MarginalMHState<B,L,S1,IO1> chain_type;
+
+  /**
+   * Chain output cache type.
+   */
+  typedef MCMCBuffer<MCMCCache<L> > cache_type;
+
+  /**
+   * Constructor.
+   *
+   * @param m Model.
+   * @param Nchains Number of chains.
+   * @param P Number of \f$x\f$-particles.
+   * @param T Number of time points.
+   */
+  MarginalMHChainsState(B& m, const int Nchains = 0, const int P = 0,
+      const int T = 0);
+
+  /**
+   * Shallow copy constructor.
+   */
+  MarginalMHChainsState(const MarginalMHChainsState<B,L,S1,IO1>& o);
+
+  /**
+   * Destructor.
+   */
+  ~MarginalMHChainsState();
+
+  /**
+   * Deep assignment operator.
+   */
+  MarginalMHChainsState& operator=(
+      const MarginalMHChainsState<B,L,S1,IO1>& o);
+
+  /**
+   * Number of chains.
+   */
+  int size() const;
+
+  /**
+   * Chains.
+   */
+  std::vector<chain_type*> chains;
+
+  /**
+   * Output caches, one for each chain. Samples are collected here, then
+   * written to the common output buffer a block at a time.
+   */
+  std::vector<cache_type*> caches;
+
+private:
+  /**
+   * Serialize.
+   */
+  template<class Archive>
+  void save(Archive& ar, const unsigned version) const;
+
+  /**
+   * Restore from serialization.
+   */
+  template<class Archive>
+  void load(Archive& ar, const unsigned version);
+
+  /*
+   * Boost.Serialization requirements.
+   */
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+  friend class boost::serialization::access;
+};
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalMHChainsState<B,L,S1,IO1>::MarginalMHChainsState(B& m,
+    const int Nchains, const int P, const int T) :
+    chains(Nchains), caches(Nchains) {
+  for (int k = 0; k < chains.size(); ++k) {
+    chains[k] = new chain_type(m, P, T);
+    caches[k] = new cache_type(m, 0, T);
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalMHChainsState<B,L,S1,IO1>::MarginalMHChainsState(
+    const MarginalMHChainsState<B,L,S1,IO1>& o) :
+    chains(o.chains.size()), caches(o.caches.size()) {
+  for (int k = 0; k < chains.size(); ++k) {
+    chains[k] = new chain_type(*o.chains[k]);
+    caches[k] = new cache_type(*o.caches[k]);
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalMHChainsState<B,L,S1,IO1>::~MarginalMHChainsState() {
+  for (int k = 0; k < chains.size(); ++k) {
+    delete chains[k];
+    delete caches[k];
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+bi::MarginalMHChainsState<B,L,S1,IO1>&
+    bi::MarginalMHChainsState<B,L,S1,IO1>::operator=(
+    const MarginalMHChainsState<B,L,S1,IO1>& o) {
+  /* pre-condition */
+  BI_ASSERT(o.size() == size());
+
+  for (int k = 0; k < chains.size(); ++k) {
+    *chains[k] = *o.chains[k];
+    *caches[k] = *o.caches[k];
+  }
+
+  return *this;
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+int bi::MarginalMHChainsState<B,L,S1,IO1>::size() const {
+  return chains.size();
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+template<class Archive>
+void bi::MarginalMHChainsState<B,L,S1,IO1>::save(Archive& ar,
+    const unsigned version) const {
+  for (int k = 0; k < chains.size(); ++k) {
+    ar & *chains[k];
+  }
+}
+
+template<class B, bi::Location L, class S1, class IO1>
+template<class Archive>
+void bi::MarginalMHChainsState<B,L,S1,IO1>::load(Archive& ar,
+    const unsigned version) {
+  for (int k = 0; k < chains.size(); ++k) {
+    ar & *chains[k];
+  }
+}
+
+#endif
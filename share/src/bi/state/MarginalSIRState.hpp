@@ -9,6 +9,7 @@
 #define BI_STATE_MARGINALSIRSTATE_HPP
 
 #include "SamplerState.hpp"
+#include "../misc/omp.hpp"
 
 #include <vector>
 
@@ -46,9 +47,12 @@ public:
    * @param Ptheta Number of \f$\theta\f$-particles.
    * @param Px Number of \f$x\f$-particles.
    * @param T Number of time points.
+   * @param parallel Will \f$\theta\f$-particles be rejuvenated in
+   * parallel? If so, there is one proposed state for each thread, otherwise
+   * just one.
    */
   MarginalSIRState(B& m, const int Ptheta = 0, const int Px = 0, const int T =
-      0);
+      0, const bool parallel = false);
 
   /**
    * Shallow copy constructor.
@@ -91,9 +95,10 @@ public:
   std::vector<state_type*> thetas;
 
   /**
-   * Proposed state.
+   * Proposed states, one for each thread if constructed for parallel
+   * rejuvenation, otherwise one only.
    */
-  state_type theta2;
+  std::vector<state_type*> theta2s;
 
   /**
    * Log-evidences.
@@ -143,22 +148,28 @@ private:
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(B& m, const int Ptheta,
-    const int Px, const int T) :
-    thetas(Ptheta), theta2(m, Px, T), les(T), lws(Ptheta), as(Ptheta), ptheta(
-        0), Ptheta(Ptheta) {
+    const int Px, const int T, const bool parallel) :
+    thetas(Ptheta), theta2s(parallel ? bi_omp_max_threads : 1), les(T), lws(Ptheta), as(
+        Ptheta), ptheta(0), Ptheta(Ptheta) {
   for (int p = 0; p < thetas.size(); ++p) {
     thetas[p] = new state_type(m, Px, T);
   }
+  for (int i = 0; i < theta2s.size(); ++i) {
+    theta2s[i] = new state_type(m, Px, T);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
 bi::MarginalSIRState<B,L,S1,IO1>::MarginalSIRState(
     const MarginalSIRState<B,L,S1,IO1>& o) :
-    thetas(o.thetas.size()), theta2(o.theta2), les(o.les), lws(o.lws), as(
-        o.as), ptheta(o.ptheta), Ptheta(o.Ptheta) {
+    thetas(o.thetas.size()), theta2s(o.theta2s.size()), les(o.les), lws(
+        o.lws), as(o.as), ptheta(o.ptheta), Ptheta(o.Ptheta) {
   for (int p = 0; p < thetas.size(); ++p) {
     thetas[p] = new state_type(*o.thetas[p]);
   }
+  for (int i = 0; i < theta2s.size(); ++i) {
+    theta2s[i] = new state_type(*o.theta2s[i]);
+  }
 }
 
 template<class B, bi::Location L, class S1, class IO1>
@@ -170,7 +181,9 @@ bi::MarginalSIRState<B,L,S1,IO1>& bi::MarginalSIRState<B,L,S1,IO1>::operator=(
   for (int p = 0; p < thetas.size(); ++p) {
     *thetas[p] = *o.thetas[p];
   }
-  theta2 = o.theta2;
+  for (int i = 0; i < theta2s.size() && i < o.theta2s.size(); ++i) {
+    *theta2s[i] = *o.theta2s[i];
+  }
   les = o.les;
   lws = o.lws;
   as = o.as;
@@ -14,9 +14,12 @@
 #include "../math/loc_matrix.hpp"
 #include "../math/loc_temp_vector.hpp"
 #include "../math/loc_temp_matrix.hpp"
+#include "../misc/omp.hpp"
 
 #include "boost/serialization/split_member.hpp"
 
+#include <map>
+
 namespace bi {
 /**
  * Round up number of trajectories as required by implementation.
@@ -33,6 +36,26 @@ namespace bi {
  * multiple of four (single precision) or two (double precision).
  */
 int roundup(const int P);
+
+/**
+ * Number of rows to allocate for the trajectories of a state.
+ *
+ * @tparam L Location.
+ *
+ * @param P Number of trajectories.
+ *
+ * @return Number of rows.
+ *
+ * Each variable of a state occupies one column of a column-major matrix.
+ * When the column length is a multiple of a large power of two, as it is
+ * for the usual numbers of trajectories, all columns map to the same cache
+ * sets, and SIMD loads of the variables of one group of trajectories evict
+ * one another. With ENABLE_PADDED_STATE, storage on host is padded to an
+ * odd number of cache lines per column, which spreads columns across cache
+ * sets. Padding rows count towards State::sizeMax().
+ */
+template<Location L>
+int padup(const int P);
 }
 
 #ifdef ENABLE_SSE
@@ -58,6 +81,25 @@ inline int bi::roundup(const int P) {
   return P1;
 }
 
+template<bi::Location L>
+inline int bi::padup(const int P) {
+  int P1 = roundup(P);
+
+  #ifdef ENABLE_PADDED_STATE
+  /* odd number of 64-byte cache lines; a cache line is a multiple of the
+   * SIMD width, so alignment is preserved */
+  static const int line = 64/sizeof(real);
+  if (L == ON_HOST && P1 > 1) {
+    P1 = ((P1 + line - 1)/line)*line;
+    if ((P1/line) % 2 == 0) {
+      P1 += line;
+    }
+  }
+  #endif
+
+  return P1;
+}
+
 namespace bi {
 /**
  * %State of Model %model.
@@ -374,6 +416,59 @@ public:
   CUDA_FUNC_BOTH
   const matrix_reference_type getDyn() const;
 
+  /**
+   * Get buffer of step sizes of adaptive ODE integrators.
+   *
+   * Each trajectory keeps the step size that an adaptive integrator
+   * proposed for it at the end of its last update, so that the next update
+   * may start from that size rather than the initial step size. Zero
+   * indicates that there is no such step size. Step sizes are stored with
+   * the state variables, and should be carried along when trajectories
+   * are resampled.
+   */
+  CUDA_FUNC_BOTH
+  vector_reference_type getStep();
+
+  /**
+   * Get buffer of step sizes of adaptive ODE integrators.
+   */
+  CUDA_FUNC_BOTH
+  const vector_reference_type getStep() const;
+
+  /**
+   * Get step size of adaptive ODE integrators.
+   *
+   * @param p Trajectory index.
+   */
+  CUDA_FUNC_BOTH
+  real& getStep(const int p);
+
+  /**
+   * Get step size of adaptive ODE integrators.
+   *
+   * @param p Trajectory index.
+   */
+  CUDA_FUNC_BOTH
+  const real& getStep(const int p) const;
+
+  /**
+   * Get buffer of integrator continuation data.
+   *
+   * @param owner Identifier of the integrator.
+   * @param N Number of columns required by the integrator.
+   *
+   * @return Buffer, with one row for each trajectory in the active range.
+   *
+   * Integrators that continue past the end of one update into the next
+   * (e.g. DOPRI5 with dense output) keep their data here. Each @p owner
+   * has its own columns, allocated and cleared on its first call, so that
+   * several integrators, e.g. one for each ode block, keep data at once.
+   * All data is cleared on assignment or when the number of trajectories
+   * changes. Integrators are responsible for checking that any data they
+   * find is consistent with the state.
+   */
+  matrix_reference_type getCache(const void* owner, const int N);
+
 protected:
   /* net sizes, for convenience */
   static const int NR = B::NR;
@@ -385,6 +480,30 @@ protected:
   static const int NPX = B::NPX;
   static const int NB = B::NB;
 
+  /**
+   * Number of internal columns for each trajectory, see getStep().
+   */
+  static const int NH = 1;
+
+  /**
+   * First touch storage for dense non-common variables.
+   *
+   * @param X Storage.
+   * @param P Number of trajectories to place.
+   *
+   * When enabled (see bi_omp_set_first_touch()), on host, each thread
+   * clears its share of the first @p P rows of @p X under an even static
+   * split, in blocks of the SIMD width when SSE is enabled, so that their
+   * pages are placed on its NUMA node. Remaining rows, and all rows
+   * otherwise, are cleared by the calling thread.
+   *
+   * Placement matches the statically scheduled updaters only. ODE
+   * integrators schedule trajectories dynamically, and tiled transitions
+   * (see bi_omp_set_tile()) split each tile rather than all trajectories,
+   * so that threads then also work on rows placed on other nodes.
+   */
+  static void touch(matrix_type& X, const int P);
+
   /**
    * Storage for dense non-common variables.
    */
@@ -400,6 +519,17 @@ protected:
    */
   real builtin[NB];
 
+  /**
+   * Storage for integrator continuation data.
+   */
+  matrix_type Cdn;
+
+  /**
+   * Owners of integrator continuation data, with the index of the first of
+   * their columns in @p Cdn, and the number of columns.
+   */
+  std::map<const void*,std::pair<int,int> > owners;
+
   /**
    * Index of starting trajectory in @p Xdn.
    */
@@ -433,21 +563,23 @@ private:
 }
 
 #include "../math/view.hpp"
+#include "../math/function.hpp"
 
 template<class B, bi::Location L>
 bi::State<B,L>::State(const int P) :
-    Xdn(P, NR + ND + NDX + NR + ND),  // includes dy- and ry-vars
+    Xdn(padup<L>(P), NR + ND + NH + NDX + NR + ND),  // includes dy- and ry-vars
     Kdn(1, NP + NPX + NF + NP + 2 * NO),  // includes py- and oy-vars
     p(0), P(P) {
   /* pre-condition */
   BI_ASSERT(P == roundup(P));
 
-  clear();
+  touch(Xdn, P);
+  Kdn.clear();
 }
 
 template<class B, bi::Location L>
 bi::State<B,L>::State(const State<B,L>& o) :
-    Xdn(o.Xdn), Kdn(o.Kdn), p(o.p), P(o.P) {
+    Xdn(o.Xdn), Kdn(o.Kdn), Cdn(o.Cdn), owners(o.owners), p(o.p), P(o.P) {
   for (int i = 0; i < NB; ++i) {
     builtin[i] = o.builtin[i];
   }
@@ -460,6 +592,7 @@ bi::State<B,L>& bi::State<B,L>::operator=(const State<B,L>& o) {
   for (int i = 0; i < NB; ++i) {
     builtin[i] = o.builtin[i];
   }
+  Cdn.clear();
   return *this;
 }
 
@@ -471,6 +604,7 @@ bi::State<B,L>& bi::State<B,L>::operator=(const State<B,L2>& o) {
   for (int i = 0; i < NB; ++i) {
     builtin[i] = o.builtin[i];
   }
+  Cdn.clear();
   return *this;
 }
 
@@ -481,6 +615,8 @@ void bi::State<B,L>::swap(State<B,L>& o) {
   for (int i = 0; i < NB; ++i) {
     std::swap(builtin[i], o.builtin[i]);
   }
+  Cdn.swap(o.Cdn);
+  owners.swap(o.owners);
 }
 
 template<class B, bi::Location L>
@@ -520,7 +656,17 @@ inline void bi::State<B,L>::resizeMax(const int maxP, const bool preserve) {
   /* pre-condition */
   BI_ASSERT(maxP == roundup(maxP));
 
-  Xdn.resize(maxP, Xdn.size2(), preserve);
+  if (bi_omp_first_touch && !on_device && padup<L>(maxP) > Xdn.size1()) {
+    /* place new storage before the copy touches it */
+    matrix_type X(padup<L>(maxP), Xdn.size2());
+    touch(X, maxP);
+    if (preserve) {
+      rows(X, 0, Xdn.size1()) = Xdn;
+    }
+    Xdn.swap(X);
+  } else {
+    Xdn.resize(padup<L>(maxP), Xdn.size2(), preserve);
+  }
   if (p > maxP) {
     p = maxP;
   }
@@ -529,6 +675,38 @@ inline void bi::State<B,L>::resizeMax(const int maxP, const bool preserve) {
   }
 }
 
+template<class B, bi::Location L>
+void bi::State<B,L>::touch(matrix_type& X, const int P) {
+  if (bi_omp_first_touch && !on_device) {
+    #pragma omp parallel
+    {
+      #ifdef ENABLE_SSE
+      const int step = BI_SIMD_SIZE;
+      #else
+      const int step = 1;
+      #endif
+      int first = -1, last = -1, p, j;
+
+      /* contiguous share of each thread, as for static updaters */
+      #pragma omp for schedule(static)
+      for (p = 0; p < P; p += step) {
+        if (first < 0) {
+          first = p;
+        }
+        last = bi::min(p + step, P) - 1;
+      }
+      if (first >= 0) {
+        for (j = 0; j < X.size2(); ++j) {
+          subrange(column(X, j), first, last - first + 1).clear();
+        }
+      }
+    }
+    rows(X, P, X.size1() - P).clear();
+  } else {
+    X.clear();
+  }
+}
+
 template<class B, bi::Location L>
 inline void bi::State<B,L>::clear() {
   rows(Xdn, p, P).clear();
@@ -574,11 +752,11 @@ inline typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::get(
   case D_VAR:
     return subrange(Xdn.ref(), p, P, NR, ND);
   case DX_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND, NDX);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH, NDX);
   case RY_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND + NDX, NR);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH + NDX, NR);
   case DY_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND + NDX + NR, ND);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH + NDX + NR, ND);
   case P_VAR:
     return columns(Kdn.ref(), 0, NP);
   case PX_VAR:
@@ -606,11 +784,11 @@ inline const typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::get(
   case D_VAR:
     return subrange(Xdn.ref(), p, P, NR, ND);
   case DX_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND, NDX);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH, NDX);
   case RY_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND + NDX, NR);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH + NDX, NR);
   case DY_VAR:
-    return subrange(Xdn.ref(), p, P, NR + ND + NDX + NR, ND);
+    return subrange(Xdn.ref(), p, P, NR + ND + NH + NDX + NR, ND);
   case P_VAR:
     return columns(Kdn.ref(), 0, NP);
   case PX_VAR:
@@ -693,11 +871,11 @@ inline real& bi::State<B,L>::getVar(const int p, const int ix) {
   case D_VAR:
     return Xdn(this->p + p, NR + start + ix);
   case DX_VAR:
-    return Xdn(this->p + p, NR + ND + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + start + ix);
   case RY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + start + ix);
   case DY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + NR + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + NR + start + ix);
   case P_VAR:
     return Kdn(0, start + ix);
   case PX_VAR:
@@ -730,11 +908,11 @@ inline const real& bi::State<B,L>::getVar(const int p, const int ix) const {
   case D_VAR:
     return Xdn(this->p + p, NR + start + ix);
   case DX_VAR:
-    return Xdn(this->p + p, NR + ND + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + start + ix);
   case RY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + start + ix);
   case DY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + NR + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + NR + start + ix);
   case P_VAR:
     return Kdn(0, start + ix);
   case PX_VAR:
@@ -767,11 +945,11 @@ inline real& bi::State<B,L>::getVarAlt(const int p, const int ix) {
   case D_VAR:
     return Xdn(this->p + p, NR + start + ix);
   case DX_VAR:
-    return Xdn(this->p + p, NR + ND + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + start + ix);
   case RY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + start + ix);
   case DY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + NR + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + NR + start + ix);
   case P_VAR:
     return Kdn(0, start + ix);
   case PX_VAR:
@@ -805,11 +983,11 @@ inline const real& bi::State<B,L>::getVarAlt(const int p,
   case D_VAR:
     return Xdn(this->p + p, NR + start + ix);
   case DX_VAR:
-    return Xdn(this->p + p, NR + ND + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + start + ix);
   case RY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + start + ix);
   case DY_VAR:
-    return Xdn(this->p + p, NR + ND + NDX + NR + start + ix);
+    return Xdn(this->p + p, NR + ND + NH + NDX + NR + start + ix);
   case P_VAR:
     return Kdn(0, start + ix);
   case PX_VAR:
@@ -850,6 +1028,47 @@ inline const typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::getD
   return subrange(Xdn.ref(), p, P, 0, NR + ND);
 }
 
+template<class B, bi::Location L>
+inline typename bi::State<B,L>::vector_reference_type bi::State<B,L>::getStep() {
+  return column(subrange(Xdn.ref(), p, P, NR + ND, NH), 0);
+}
+
+template<class B, bi::Location L>
+inline const typename bi::State<B,L>::vector_reference_type bi::State<B,L>::getStep() const {
+  return column(subrange(Xdn.ref(), p, P, NR + ND, NH), 0);
+}
+
+template<class B, bi::Location L>
+inline real& bi::State<B,L>::getStep(const int p) {
+  return Xdn(this->p + p, NR + ND);
+}
+
+template<class B, bi::Location L>
+inline const real& bi::State<B,L>::getStep(const int p) const {
+  return Xdn(this->p + p, NR + ND);
+}
+
+template<class B, bi::Location L>
+typename bi::State<B,L>::matrix_reference_type bi::State<B,L>::getCache(
+    const void* owner, const int N) {
+  if (Cdn.size1() != Xdn.size1()) {
+    Cdn.resize(Xdn.size1(), 0, false);
+    owners.clear();
+  }
+
+  std::map<const void*,std::pair<int,int> >::iterator iter = owners.find(
+      owner);
+  if (iter == owners.end() || iter->second.second != N) {
+    /* new columns, keeping those of other owners */
+    const int start = Cdn.size2();
+    Cdn.resize(Cdn.size1(), start + N, true);
+    columns(Cdn, start, N).clear();
+    owners[owner] = std::make_pair(start, N);
+    iter = owners.find(owner);
+  }
+  return subrange(Cdn.ref(), p, P, iter->second.first, N);
+}
+
 template<class B, bi::Location L>
 template<class Archive>
 void bi::State<B,L>::save(Archive& ar, const unsigned version) const {
@@ -868,6 +1087,7 @@ void bi::State<B,L>::load(Archive& ar, const unsigned version) {
   ar & builtin;
   ar & p;
   ar & P;
+  Cdn.clear();
 }
 
 #endif
@@ -33,6 +33,18 @@ struct action_is_matrix {
   static const int value = A::IS_MATRIX;
 };
 
+/**
+ * Can action be evaluated for a SIMD vector of trajectories at once?
+ *
+ * @ingroup model_low
+ *
+ * @tparam A Action type.
+ */
+template<class A>
+struct action_is_simd {
+  static const bool value = A::IS_SIMD;
+};
+
 /**
  * Start of action in action type list (cumulative sum of the sizes of
  * all preceding actions).
@@ -122,6 +122,30 @@ struct block_is_matrix<empty_typelist> {
   static const bool value = true;
 };
 
+/**
+ * Can all actions of this block be evaluated for a SIMD vector of
+ * trajectories at once?
+ */
+template<class S>
+struct block_is_simd {
+  typedef typename front<S>::type front;
+  typedef typename pop_front<S>::type pop_front;
+
+  static const bool value = action_is_simd<front>::value && block_is_simd<pop_front>::value;
+};
+
+/**
+ * @internal
+ *
+ * Base case of block_is_simd.
+ *
+ * @ingroup model_low
+ */
+template<>
+struct block_is_simd<empty_typelist> {
+  static const bool value = true;
+};
+
 }
 
 #endif
@@ -31,6 +31,19 @@ template<class R>
 struct resampler_needs_max {
   static const bool value = false;
 };
+
+/**
+ * Can resampling be split into the selection of ancestors, with
+ * <tt>ancestorsPermute()</tt>, and the copy of particles, with
+ * Resampler::copy()? The copy may then be shared among the threads of a
+ * persistent team.
+ *
+ * @ingroup method_resampler
+ */
+template<class R>
+struct resampler_can_split {
+  static const bool value = false;
+};
 }
 
 #endif
@@ -51,6 +51,27 @@ public:
   static void logDensities(State<B,ON_HOST>& s, const int p,
       const Mask<ON_HOST>& mask, V1 lp);
 
+  /**
+   * Evaluate log-density, and reduce the result in the same pass.
+   *
+   * @tparam V1 Vector type.
+   *
+   * @param[in,out] s State.
+   * @param mask Sparsity mask.
+   * @param[in,out] lp Log-density.
+   * @param[out] mx Maximum of updated @p lp.
+   * @param[out] sum1 Sum-exp of updated @p lp, relative to @p mx.
+   * @param[out] sum2 Sum-exp-square of updated @p lp, relative to @p mx.
+   *
+   * The log density is <i>added to</i> @p lp, and the results of
+   * max_sumexp_reduce() on the updated @p lp are computed while it is
+   * still in cache.
+   */
+  template<class V1>
+  static void logDensities(State<B,ON_HOST>& s, const Mask<ON_HOST>& mask,
+      V1 lp, typename V1::value_type& mx, typename V1::value_type& sum1,
+      typename V1::value_type& sum2);
+
   #ifdef __CUDACC__
   /**
    * Evaluate log-density.
@@ -82,6 +103,16 @@ public:
   template<class V1>
   static void logDensities(State<B,ON_DEVICE>& s, const int p,
       const Mask<ON_DEVICE>& mask, V1 lp);
+
+  /**
+   * Evaluate log-density, and reduce the result.
+   *
+   * @copydetails logDensities(State<B,ON_HOST>&, const Mask<ON_HOST>&, V1, typename V1::value_type&, typename V1::value_type&, typename V1::value_type&)
+   */
+  template<class V1>
+  static void logDensities(State<B,ON_DEVICE>& s,
+      const Mask<ON_DEVICE>& mask, V1 lp, typename V1::value_type& mx,
+      typename V1::value_type& sum1, typename V1::value_type& sum2);
   #endif
 };
 }
@@ -93,6 +124,7 @@ public:
 #ifdef __CUDACC__
 #include "../cuda/updater/SparseStaticLogDensityGPU.cuh"
 #endif
+#include "../primitive/vector_primitive.hpp"
 
 template<class B, class S>
 template<class V1>
@@ -117,6 +149,14 @@ void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_HOST>& s,
   SparseStaticLogDensityHost<B,S>::logDensities(s, p, mask, lp);
 }
 
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_HOST>& s,
+    const Mask<ON_HOST>& mask, V1 lp, typename V1::value_type& mx,
+    typename V1::value_type& sum1, typename V1::value_type& sum2) {
+  SparseStaticLogDensityHost<B,S>::logDensities(s, mask, lp, mx, sum1, sum2);
+}
+
 #ifdef __CUDACC__
 template<class B, class S>
 template<class V1>
@@ -131,6 +171,16 @@ void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_DEVICE>& s,
     const int p, const Mask<ON_DEVICE>& mask, V1 lp) {
   SparseStaticLogDensityGPU<B,S>::logDensities(s, p, mask, lp);
 }
+
+template<class B, class S>
+template<class V1>
+void bi::SparseStaticLogDensity<B,S>::logDensities(State<B,ON_DEVICE>& s,
+    const Mask<ON_DEVICE>& mask, V1 lp, typename V1::value_type& mx,
+    typename V1::value_type& sum1, typename V1::value_type& sum2) {
+  /* not fused on device, where the reduction is cheap relative to launch */
+  SparseStaticLogDensityGPU<B,S>::logDensities(s, mask, lp);
+  max_sumexp_reduce(lp, mx, sum1, sum2);
+}
 #endif
 
 #endif
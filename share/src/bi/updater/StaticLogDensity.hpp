@@ -79,6 +79,9 @@ public:
 }
 
 #include "../host/updater/StaticLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/StaticLogDensitySSE.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticLogDensityGPU.cuh"
 #endif
@@ -86,7 +89,17 @@ public:
 template<class B, class S>
 template<class V1>
 void bi::StaticLogDensity<B,S>::logDensities(State<B,ON_HOST>& s, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      StaticLogDensitySSE<B,S>,StaticLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0 && lp.inc() == 1) {
+    impl::logDensities(s, lp);
+  } else {
+    StaticLogDensityHost<B,S>::logDensities(s, lp);
+  }
+  #else
   StaticLogDensityHost<B,S>::logDensities(s, lp);
+  #endif
 }
 
 template<class B, class S>
@@ -79,6 +79,9 @@ public:
 }
 
 #include "../host/updater/StaticMaxLogDensityHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/StaticMaxLogDensitySSE.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticMaxLogDensityGPU.cuh"
 #endif
@@ -86,7 +89,17 @@ public:
 template<class B, class S>
 template<class V1>
 void bi::StaticMaxLogDensity<B,S>::maxLogDensities(State<B,ON_HOST>& s, V1 lp) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      StaticMaxLogDensitySSE<B,S>,StaticMaxLogDensityHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0 && lp.inc() == 1) {
+    impl::maxLogDensities(s, lp);
+  } else {
+    StaticMaxLogDensityHost<B,S>::maxLogDensities(s, lp);
+  }
+  #else
   StaticMaxLogDensityHost<B,S>::maxLogDensities(s, lp);
+  #endif
 }
 
 template<class B, class S>
@@ -59,13 +59,26 @@ public:
 }
 
 #include "../host/updater/StaticSamplerHost.hpp"
+#ifdef ENABLE_SSE
+#include "../sse/updater/StaticSamplerSSE.hpp"
+#endif
 #ifdef __CUDACC__
 #include "../cuda/updater/StaticSamplerGPU.cuh"
 #endif
 
 template<class B, class S>
 void bi::StaticSampler<B,S>::samples(Random& rng, State<B,ON_HOST>& s) {
+  #ifdef ENABLE_SSE
+  typedef typename boost::mpl::if_c<block_is_simd<S>::value,
+      StaticSamplerSSE<B,S>,StaticSamplerHost<B,S> >::type impl;
+  if (s.size() % BI_SIMD_SIZE == 0) {
+    impl::samples(rng, s);
+  } else {
+    StaticSamplerHost<B,S>::samples(rng, s);
+  }
+  #else
   StaticSamplerHost<B,S>::samples(rng, s);
+  #endif
 }
 
 template<class B, class S>